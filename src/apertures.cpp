@@ -22,6 +22,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include <vector>
 #include <list>
 #include <map>
+#ifndef __linux__
+#define HAVE_STRUCT_TIMESPEC
+#endif
+#include <pthread.h>
 
 using namespace std;
 
@@ -53,32 +57,236 @@ const char * Aperture::rs274x_name()
 	case SPECIAL_POLYGON : 		return "special polygon";
 	case SPECIAL_MOIRE : 		return "special moire";
 	case SPECIAL_THERMAL : 		return "special thermal";
+	case BLOCK : 					return "block aperture";
 	}
 	return "Invalid primitive";
 }
 
 
 //
-// Safely gets value from Aperture::modifier at element number idx
+// Safely gets value from Aperture::arguments at element number idx
 //
 double Aperture::getParameter(int idx)
 {
 	ostringstream oss;
-	if (idx >= parameter.size())
+	if (idx < 0 || idx >= parameterCount)
 	{
 		oss	<<"modifier expected at position "<<(idx+1);
 		throw oss.str();
 	}
-	try
+	int status = arguments->status[firstParameter + idx];
+	if (status == 0)
+		return arguments->value[firstParameter + idx];
+	if (status < 0)
+		oss <<"division by zero";
+	else
+		oss<<"variable $"<<status<<" has not been assigned";
+	oss <<" at parameter "<<idx+1;
+	throw oss.str();
+}
+
+
+//------------------------------------------------------------
+// Build the ApertureCache key of this primitive from its parameter values and the render settings.
+// Returns false if the aperture must not be cached, e.g. a parameter failed to evaluate.
+bool Aperture::cacheKey(double dots_per_unit, double grow_size, int ADmodifierCount, const double * scale, vector<double> &key)
+{
+	key.clear();
+	key.push_back(primitive);
+	key.push_back(ADmodifierCount);
+	key.push_back(dots_per_unit);
+	key.push_back(grow_size);
+	key.push_back(scale[0]);
+	key.push_back(scale[1]);
+	for (int i=0; i < parameterCount; i++)
 	{
-		return parameter[idx]->evaluate();
+		double value = arguments->value[firstParameter + i];
+		if (arguments->status[firstParameter + i] != 0 || value != value)
+			return false;
+		key.push_back(value);
 	}
-	catch (string msg)
+	return true;
+}
+
+
+struct CachedAperture
+{
+	list<Polygon> polygons;
+	double standardApWidth;
+	double standardApHeight;
+};
+
+static map< vector<double>, CachedAperture > apertureCache;
+static pthread_mutex_t apertureCacheLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Copy the cached polygons for /key to /arp. Returns false if not cached.
+bool ApertureCache::find(const vector<double> &key, Aperture &arp)
+{
+	pthread_mutex_lock(&apertureCacheLock);
+	map< vector<double>, CachedAperture >::iterator it = apertureCache.find(key);
+	bool isFound = (it != apertureCache.end());
+	if (isFound)
 	{
-		oss <<msg<<" at parameter "<<idx+1;
-		throw oss.str();
+		arp.polygons = it->second.polygons;
+		arp.standardApWidth = it->second.standardApWidth;
+		arp.standardApHeight = it->second.standardApHeight;
+	}
+	pthread_mutex_unlock(&apertureCacheLock);
+	return isFound;
+}
+
+// Add the rendered and scaled aperture /arp. Its vertex extents are initialised here and become shared.
+// If another thread added the same aperture meanwhile, /arp is changed to use that one.
+void ApertureCache::insert(const vector<double> &key, Aperture &arp)
+{
+	for (list<Polygon>::iterator it = arp.polygons.begin(); it != arp.polygons.end(); it++)
+	{
+		it->vdata->initialiseExtents();
+		it->vdata->isShared = true;
+	}
+	pthread_mutex_lock(&apertureCacheLock);
+	map< vector<double>, CachedAperture >::iterator it = apertureCache.find(key);
+	if (it == apertureCache.end())
+	{
+		CachedAperture &cached = apertureCache[key];
+		cached.polygons = arp.polygons;
+		cached.standardApWidth = arp.standardApWidth;
+		cached.standardApHeight = arp.standardApHeight;
+	}
+	else
+		arp.polygons = it->second.polygons;
+	pthread_mutex_unlock(&apertureCacheLock);
+}
+
+
+//------------------------------------------------------------
+// Compile the expression of the next parameter. Returns the parameter index.
+int MacroProgram::compile(const NodeT * expr)
+{
+	int depth = emit(expr);
+	if (depth > stackSize)
+		stackSize = depth;
+	add(STORE);
+	return parameterCount++;
+}
+
+void MacroProgram::add(OpCode op, double value, int varID)
+{
+	Instruction ins;
+	ins.op = op;
+	ins.value = value;
+	ins.varID = varID;
+	code.push_back(ins);
+}
+
+// Evaluate /node if it does not depend on any variable. A division by zero is not folded,
+// so the error is reported when the parameter is used.
+bool MacroProgram::fold(const NodeT * node, double &value)
+{
+	double a, b;
+	switch (node->type)
+	{
+	case NodeT::CONSTANT:	value = node->arg1.value; return true;
+	case NodeT::VAR:		return false;
+	case NodeT::OPNEG:
+		if (!fold(node->arg1.node, a))	return false;
+		value = -a;
+		return true;
+	}
+	if (!fold(node->arg1.node, a) || !fold(node->arg2.node, b))
+		return false;
+	switch (node->type)
+	{
+	case NodeT::OPADD:	value = a + b; break;
+	case NodeT::OPSUB:	value = a - b; break;
+	case NodeT::OPMUL:	value = a * b; break;
+	case NodeT::OPDIV:
+		if (b == 0)	return false;
+		value = a / b;
+		break;
+	}
+	return true;
+}
+
+// Append the instructions of /node in postfix order. Returns the stack depth needed.
+int MacroProgram::emit(const NodeT * node)
+{
+	double value;
+	if (fold(node, value))
+	{
+		add(PUSH_CONST, value);
+		return 1;
+	}
+	switch (node->type)
+	{
+	case NodeT::VAR:
+		add(PUSH_VAR, 0, node->arg1.varID);
+		return 1;
+	case NodeT::OPNEG:
+	{
+		int depth = emit(node->arg1.node);
+		add(NEG);
+		return depth;
+	}
+	}
+	int depth1 = emit(node->arg1.node);
+	int depth2 = emit(node->arg2.node) + 1;
+	switch (node->type)
+	{
+	case NodeT::OPADD:	add(ADD); break;
+	case NodeT::OPSUB:	add(SUB); break;
+	case NodeT::OPMUL:	add(MUL); break;
+	case NodeT::OPDIV:	add(DIV); break;
 	}
+	return max(depth1, depth2);
+}
 
+// Evaluate all parameters with $n taken from variables[n-1].
+void MacroProgram::run(const std::vector<double> &variables, MacroValues &values) const
+{
+	vector<double> stack(stackSize + 1);
+	values.value.resize(parameterCount);
+	values.status.assign(parameterCount, 0);
+	int sp = 0;
+	int n = 0;
+	for (size_t pc = 0; pc < code.size(); pc++)
+	{
+		const Instruction &ins = code[pc];
+		int status = 0;
+		switch (ins.op)
+		{
+		case PUSH_CONST:	stack[sp++] = ins.value; break;
+		case PUSH_VAR:
+			if (ins.varID >= (int)variables.size())
+				status = ins.varID + 1;
+			else
+				stack[sp++] = variables[ins.varID];
+			break;
+		case NEG:	stack[sp-1] = -stack[sp-1]; break;
+		case ADD:	sp--; stack[sp-1] += stack[sp]; break;
+		case SUB:	sp--; stack[sp-1] -= stack[sp]; break;
+		case MUL:	sp--; stack[sp-1] *= stack[sp]; break;
+		case DIV:
+			sp--;
+			if (stack[sp] == 0)
+				status = -1;
+			else
+				stack[sp-1] /= stack[sp];
+			break;
+		case STORE:
+			values.value[n++] = stack[--sp];
+			break;
+		}
+		if (status != 0)
+		{
+			// skip the rest of this parameter
+			values.value[n] = 0;
+			values.status[n++] = status;
+			while (code[pc].op != STORE)
+				pc++;
+			sp = 0;
+		}
+	}
 }
 
 
@@ -139,15 +347,16 @@ void Aperture::render(const double dots_per_unit, const double grow_size, int AD
 
     	double arc_offset = (xsize - ysize)/2;
 
+	    // kept as arcs, the scan lines are made from the chords, see VertexData::isObround()
 	    if (xsize > ysize )	// horizontal orbround
 	    {
-	    	polygons.back().vdata->addArc(0.5*M_PI, 1.5*M_PI, ysize/2, x_center - arc_offset , y_center);
-	    	polygons.back().vdata->addArc(1.5*M_PI, 2.5*M_PI, ysize/2, x_center + arc_offset, y_center);
+	    	polygons.back().vdata->addArcEdge(0.5*M_PI, 1.5*M_PI, ysize/2, x_center - arc_offset , y_center);
+	    	polygons.back().vdata->addArcEdge(1.5*M_PI, 2.5*M_PI, ysize/2, x_center + arc_offset, y_center);
 	    }
 	    else				// vertical orbround or circle
 	    {
-	    	polygons.back().vdata->addArc(0*M_PI, 1*M_PI, xsize/2, x_center , y_center - arc_offset);
-	    	polygons.back().vdata->addArc(1*M_PI, 2*M_PI, xsize/2, x_center , y_center + arc_offset);
+	    	polygons.back().vdata->addArcEdge(0*M_PI, 1*M_PI, xsize/2, x_center , y_center - arc_offset);
+	    	polygons.back().vdata->addArcEdge(1*M_PI, 2*M_PI, xsize/2, x_center , y_center + arc_offset);
 	    }
 	    break;
 	} // end of case
@@ -343,9 +552,9 @@ void Aperture::render(const double dots_per_unit, const double grow_size, int AD
 
 		// rotation radians (+ = counterclockwise, - = clockwise)
 		// last parameter is always specifies rotation regardless of number of surplus vertices.
-		rotation = parameter.back()->evaluate() * M_PI / 180.0;
+		rotation = getParameter(parameterCount - 1) * M_PI / 180.0;
 
-		if (num_points*2 + 3 > parameter.size() )
+		if (num_points*2 + 3 > parameterCount )
 			throw string("specified number of points exceeds number of vertices listed");
 
 		for (int i=0; i < num_points; i++ )
@@ -406,6 +615,6 @@ void Aperture::render(const double dots_per_unit, const double grow_size, int AD
 		if ( standardHoleY > 0.5 )
 			polygons.back().vdata->addRectangle(standardHoleX, standardHoleY);
 		else
-		    polygons.back().vdata->addArc( 0, 2*M_PI, standardHoleX / 2, 0, 0, false);
+		    polygons.back().vdata->addArcEdge( 0, 2*M_PI, standardHoleX / 2, 0, 0, false);
 	}
 }
@@ -67,33 +67,57 @@ public:
 			break;
 		}
 	}
-	double evaluate()
+	~NodeT()
 	{
 		switch (type)
 		{
-		case OPNEG:		return -arg1.node->evaluate();
-		case OPADD:		return arg1.node->evaluate() + arg2.node->evaluate();
-		case OPSUB:		return arg1.node->evaluate() - arg2.node->evaluate();
-		case OPMUL:		return arg1.node->evaluate() * arg2.node->evaluate();
-		case OPDIV:
-			{
-				double d = arg2.node->evaluate();
-				if (d == 0) throw std::string("division by zero");
-				return arg1.node->evaluate() / d;
-			}
-		case CONSTANT:	return arg1.value;
-		case VAR:
-			if (arg1.varID >= arg2.variables->size())
-			{
-				std::ostringstream oss;
-				oss<<"variable $"<<(arg1.varID+1)<<" has not been assigned";
-				throw oss.str();
-			}
-			return (*arg2.variables)[arg1.varID];
+		case OPADD:
+		case OPSUB:
+		case OPMUL:
+		case OPDIV:		delete arg2.node;		// fall through
+		case OPNEG:		delete arg1.node;
 		}
 	}
 };
 
+
+// Values of the parameters of a macro for one %AD instantiation, filled by MacroProgram::run().
+// A parameter that failed to evaluate has a non zero status: -1 for a division by zero,
+// or n when variable $n has not been assigned. The error is only reported if the parameter is used.
+struct MacroValues
+{
+	std::vector<double> value;
+	std::vector<int> status;
+};
+
+// The parameter expressions of all the primitives of an %AM macro, compiled into a single
+// stack machine program when the macro is defined. Constant sub-expressions are folded.
+// Each parameter ends with a STORE instruction, so one run evaluates every primitive.
+// A program is never changed after compiling and may be shared by several parsers.
+class MacroProgram
+{
+public:
+	enum OpCode { PUSH_CONST, PUSH_VAR, NEG, ADD, SUB, MUL, DIV, STORE };
+	struct Instruction
+	{
+		OpCode op;
+		int varID;
+		double value;
+	};
+	std::vector<Instruction> code;
+	int parameterCount;
+	int stackSize;
+
+	MacroProgram() : parameterCount(0), stackSize(0) {}
+	int compile(const NodeT * expr);
+	void run(const std::vector<double> &variables, MacroValues &values) const;
+
+private:
+	int emit(const NodeT * node);
+	static bool fold(const NodeT * node, double &value);
+	void add(OpCode op, double value = 0, int varID = 0);
+};
+
 class Gerber;
 
 // abstract class; defines base members for an aperture object.
@@ -117,6 +141,7 @@ class Aperture
 						SPECIAL_POLYGON = 5,
 						SPECIAL_MOIRE = 6,
 						SPECIAL_THERMAL = 7,
+						BLOCK = 'B',				// %AB block aperture, polygons copied from the file
 						PRIMITIVE_INVALID = -1
 						} primitive;
 
@@ -128,24 +153,49 @@ class Aperture
 		double standardApHeight;				//  used to determine track width when linear and arc drawing plotting
 
 
-		std::vector< NodeT  * > parameter;
+		std::vector< NodeT  * > parameter;		// expressions of an %AM primitive, until compiled into program
+		const MacroProgram * program;			// parameters of all primitives of the macro
+		int firstParameter;						// index of the first parameter of this primitive in program
+		int parameterCount;
+		const MacroValues * arguments;			// parameter values while rendering
 
         int   		DCode;
         std::string nameMacro;
         std::list<Polygon> 	polygons;			// A list of polygons that making up this aperture. Created by member render()
+        Extents		extents;					// bounding box of the polygons of all composite parts, made by the first flash in lint mode
+        std::map<std::string, std::string> attributes;	// X2 aperture attributes set by %TA when defined, e.g. .AperFunction
+        bool		isDropped;					// flashes and traces are not drawn, the function is filtered out
 
         double getParameter(int index);
 		void render(const double dots_per_unit, const double grow_size, int ADmodifierCount );
+		bool cacheKey(double dots_per_unit, double grow_size, int ADmodifierCount, const double * scale, std::vector<double> &key);
 
         Aperture()
         {
         	standardApWidth = 0;
         	standardApHeight = 0;
             composite = 0;
+            program = 0;
+            firstParameter = 0;
+            parameterCount = 0;
+            arguments = 0;
             primitive = PRIMITIVE_INVALID;
             DCode = -1;
+            isDropped = false;
         }
 };
 
 
+
+// Process-wide cache of rendered apertures, shared by all the Gerber files parsed, also concurrently.
+// Apertures with the same primitive, parameter values, resolution, grow size and scale are rendered,
+// scaled and have their extents initialised once. Their polygons then share VertexData flagged isShared.
+class ApertureCache
+{
+public:
+	static bool find(const std::vector<double> &key, Aperture &arp);
+	static void insert(const std::vector<double> &key, Aperture &arp);
+};
+
+
 #endif  // APERTURES_H_
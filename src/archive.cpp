@@ -0,0 +1,623 @@
+/*	Streaming of Gerber files out of zip, gzip and tar archives.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <unistd.h>
+#include <signal.h>
+#else
+#include <io.h>
+#define HAVE_STRUCT_TIMESPEC
+#endif
+#include <pthread.h>
+
+#include "inflate.h"
+#include "archive.h"
+
+using namespace std;
+
+
+//--------------------------------------------------------------------------------------------------
+// Pipes carrying the decompressed members to the parser
+//--------------------------------------------------------------------------------------------------
+static bool createPipe(int fds[2])
+{
+#ifdef __linux__
+	if (pipe(fds) != 0)
+		return false;
+#ifdef F_SETPIPE_SZ
+	fcntl(fds[1], F_SETPIPE_SZ, 1 << 20);		// a larger pipe lets the decompression run further ahead
+#endif
+	return true;
+#else
+	return _pipe(fds, 1 << 20, _O_BINARY) == 0;
+#endif
+}
+
+static FILE * openPipe(int fd)
+{
+#ifdef __linux__
+	return fdopen(fd, "rb");
+#else
+	return _fdopen(fd, "rb");
+#endif
+}
+
+static void closePipe(int &fd)
+{
+	if (fd < 0)
+		return;
+#ifdef __linux__
+	close(fd);
+#else
+	_close(fd);
+#endif
+	fd = -1;
+}
+
+// Writes all the data to the pipe. Returns false when the reader has closed the pipe.
+static bool writePipe(int fd, const unsigned char * data, size_t length)
+{
+	while (length > 0)
+	{
+		unsigned n = (unsigned)min(length, size_t(1 << 20));
+#ifdef __linux__
+		ssize_t written = write(fd, data, n);
+#else
+		int written = _write(fd, data, n);
+#endif
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written <= 0)
+			return false;
+		data += written;
+		length -= written;
+	}
+	return true;
+}
+
+
+class PipeSink : public InflateSink
+{
+	public:
+		int fd;
+		PipeSink(int fd) : fd(fd) { }
+		bool write(const unsigned char * data, size_t length)	{ return writePipe(fd, data, length); }
+};
+
+// Keeps the first bytes of a stream, then stops it.
+class HeadSink : public InflateSink
+{
+	public:
+		string data;
+		size_t size;
+		HeadSink(size_t size) : size(size) { }
+		bool write(const unsigned char * p, size_t length)
+		{
+			data.append((const char *)p, min(length, size - data.size()));
+			return data.size() < size;
+		}
+};
+
+
+//--------------------------------------------------------------------------------------------------
+// Walks through the blocks of a tar stream. It lists the regular files, or writes them to the
+// pipes of the members selected by their index.
+//--------------------------------------------------------------------------------------------------
+class TarWalker : public InflateSink
+{
+	public:
+		vector<Archive::Member> * list;			// members found, when listing
+		map<unsigned, int> targets;				// pipe of selected members, by index of regular file
+
+		TarWalker() : list(0), headerFill(0), remaining(0), padding(0), type(0), isEnd(false), regularCount(0), target(-1) { }
+		~TarWalker();
+		bool write(const unsigned char * data, size_t length);
+
+	private:
+		unsigned char header[512];
+		size_t headerFill;
+		unsigned long long remaining;			// data bytes left in the current entry
+		size_t padding;							// bytes to the next block boundary after the data
+		char type;
+		bool isEnd;
+		unsigned regularCount;
+		int target;								// pipe of the current member, -1 if not selected
+		string extended;						// data of a GNU long name or pax header entry
+		string longName;
+
+		void startEntry();
+		void endEntry();
+};
+
+TarWalker::~TarWalker()
+{
+	// readers of members not found see the end of file
+	for (map<unsigned, int>::iterator it = targets.begin(); it != targets.end(); it++)
+		closePipe(it->second);
+}
+
+static unsigned long long tarNumber(const unsigned char * field, int size)
+{
+	unsigned long long n = 0;
+	if (field[0] & 0x80)						// GNU base-256 encoding of large sizes
+	{
+		for (int i=1; i < size; i++)
+			n = (n << 8) | field[i];
+		return n;
+	}
+	for (int i=0; i < size && field[i] >= '0' && field[i] <= '7'; i++)
+		n = n * 8 + (field[i] - '0');
+	return n;
+}
+
+static string tarString(const unsigned char * field, int size)
+{
+	const char * s = (const char *)field;
+	return string(s, find(s, s + size, 0));
+}
+
+void TarWalker::startEntry()
+{
+	bool isZero = true;
+	for (int i=0; i < 512 && isZero; i++)
+		isZero = (header[i] == 0);
+	if (isZero)
+	{
+		isEnd = true;
+		return;
+	}
+
+	type = header[156];
+	remaining = tarNumber(header + 124, 12);
+	padding = size_t((512 - remaining % 512) % 512);
+	extended.erase();
+	target = -1;
+	if (type == '0' || type == 0 || type == '7')
+	{
+		string name = longName;
+		if (name.empty())
+		{
+			name = tarString(header, 100);
+			string prefix = tarString(header + 345, 155);
+			if (memcmp(header + 257, "ustar", 5) == 0 && !prefix.empty())
+				name = prefix + "/" + name;
+		}
+		longName.erase();
+		if (list)
+		{
+			Archive::Member member;
+			member.name = name;
+			member.offset = 0;
+			member.compressedSize = member.size = remaining;
+			member.method = 0;
+			member.crc = 0;
+			list->push_back(member);
+		}
+		map<unsigned, int>::iterator it = targets.find(regularCount++);
+		if (it != targets.end())
+			target = it->second;
+	}
+	else if (type != 'L' && type != 'x')
+		longName.erase();
+	if (remaining == 0)
+		endEntry();
+}
+
+void TarWalker::endEntry()
+{
+	if (target >= 0)
+	{
+		closePipe(targets[regularCount - 1]);
+		target = -1;
+	}
+	if (type == 'L')							// GNU long name of the next entry
+		longName = extended.c_str();
+	else if (type == 'x')						// pax records "length key=value\n"
+	{
+		size_t n = 0;
+		while (n < extended.size())
+		{
+			size_t length = atol(extended.c_str() + n);
+			size_t key = extended.find(' ', n);
+			if (length == 0 || key == string::npos || n + length > extended.size())
+				break;
+			if (extended.compare(key + 1, 5, "path=") == 0)
+				longName = extended.substr(key + 6, n + length - (key + 6) - 1);
+			n += length;
+		}
+	}
+}
+
+bool TarWalker::write(const unsigned char * data, size_t length)
+{
+	while (length > 0 && !isEnd)
+	{
+		if (remaining > 0)
+		{
+			size_t n = (size_t)min((unsigned long long)length, remaining);
+			if (target >= 0)
+			{
+				if (!writePipe(target, data, n))	// the parser stopped reading, skip the rest of the member
+				{
+					closePipe(targets[regularCount - 1]);
+					target = -1;
+				}
+			}
+			else if (type == 'L' || type == 'x')
+				extended.append((const char *)data, n);
+			data += n;
+			length -= n;
+			remaining -= n;
+			if (remaining == 0)
+				endEntry();
+		}
+		else if (padding > 0)
+		{
+			size_t n = min(length, padding);
+			data += n;
+			length -= n;
+			padding -= n;
+		}
+		else
+		{
+			size_t n = min(length, sizeof(header) - headerFill);
+			memcpy(header + headerFill, data, n);
+			headerFill += n;
+			data += n;
+			length -= n;
+			if (headerFill == sizeof(header))
+			{
+				headerFill = 0;
+				startEntry();
+			}
+		}
+	}
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Archive
+//--------------------------------------------------------------------------------------------------
+struct Archive::Producer
+{
+	Archive * archive;
+	vector<unsigned> members;
+	vector<int> fds;					// write end of the pipe of each member
+	pthread_t thread;
+	bool isStarted;
+	string error;
+};
+
+
+Archive::Archive()
+{
+	format = ZIP;
+}
+
+Archive::~Archive()
+{
+	finish();
+}
+
+
+static unsigned readU16(const unsigned char * p)	{ return p[0] | (p[1] << 8); }
+static unsigned long readU32(const unsigned char * p)	{ return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned long)p[3] << 24); }
+static unsigned long long readU64(const unsigned char * p)	{ return readU32(p) | ((unsigned long long)readU32(p + 4) << 32); }
+
+
+// Reads the central directory of a zip file
+void Archive::listZip()
+{
+	const unsigned char * data = (const unsigned char *)file.data;
+	size_t size = file.size;
+	if (size < 22)
+		throw string("truncated zip file");
+
+	// find the end of central directory record, followed by a comment of up to 64k
+	size_t eocd = size - 22;
+	while (readU32(data + eocd) != 0x06054B50)
+	{
+		if (eocd == 0 || size - eocd > 22 + 0xFFFF)
+			throw string("zip central directory not found");
+		eocd--;
+	}
+	unsigned long long count = readU16(data + eocd + 10);
+	unsigned long long offset = readU32(data + eocd + 16);
+	if ((count == 0xFFFF || offset == 0xFFFFFFFF) && eocd >= 20 && readU32(data + eocd - 20) == 0x07064B50)
+	{
+		unsigned long long eocd64 = readU64(data + eocd - 20 + 8);		// zip64 end of central directory
+		if (eocd64 + 56 > size || readU32(data + eocd64) != 0x06064B50)
+			throw string("invalid zip64 end of central directory");
+		count = readU64(data + eocd64 + 32);
+		offset = readU64(data + eocd64 + 48);
+	}
+
+	for (unsigned long long i=0; i < count; i++)
+	{
+		if (offset + 46 > size || readU32(data + offset) != 0x02014B50)
+			throw string("invalid zip central directory");
+		const unsigned char * entry = data + offset;
+		unsigned nameLength = readU16(entry + 28);
+		unsigned extraLength = readU16(entry + 30);
+		unsigned commentLength = readU16(entry + 32);
+		if (offset + 46 + nameLength + extraLength > size)
+			throw string("invalid zip central directory");
+
+		Member member;
+		member.name.assign((const char *)entry + 46, nameLength);
+		member.method = (readU16(entry + 8) & 1) ? -1 : readU16(entry + 10);	// -1 when encrypted
+		member.crc = readU32(entry + 16);
+		member.compressedSize = readU32(entry + 20);
+		member.size = readU32(entry + 24);
+		member.offset = readU32(entry + 42);
+
+		// zip64 sizes and offset, present for the fields set to 0xFFFFFFFF
+		const unsigned char * extra = entry + 46 + nameLength;
+		const unsigned char * extraEnd = extra + extraLength;
+		while (extra + 4 <= extraEnd)
+		{
+			unsigned id = readU16(extra);
+			unsigned length = readU16(extra + 2);
+			const unsigned char * field = extra + 4;
+			const unsigned char * fieldEnd = min(field + length, extraEnd);
+			if (id == 0x0001)
+			{
+				if (member.size == 0xFFFFFFFF && field + 8 <= fieldEnd)				{ member.size = readU64(field); field += 8; }
+				if (member.compressedSize == 0xFFFFFFFF && field + 8 <= fieldEnd)	{ member.compressedSize = readU64(field); field += 8; }
+				if (member.offset == 0xFFFFFFFF && field + 8 <= fieldEnd)			{ member.offset = readU64(field); field += 8; }
+			}
+			extra += 4 + length;
+		}
+		offset += 46 + nameLength + extraLength + commentLength;
+
+		if (!member.name.empty() && member.name[member.name.size() - 1] != '/')		// skip directories
+			members.push_back(member);
+	}
+}
+
+void Archive::listTar(bool isCompressed)
+{
+	TarWalker walker;
+	walker.list = &members;
+	if (isCompressed)
+		gunzip((const unsigned char *)file.data, file.size, walker);
+	else
+		walker.write((const unsigned char *)file.data, file.size);
+}
+
+
+bool Archive::open(const char * name)
+{
+	filename = name;
+	members.clear();
+	if (!file.map(name))
+	{
+		error = "cannot open archive " + filename;
+		return false;
+	}
+	const unsigned char * data = (const unsigned char *)file.data;
+	size_t size = file.size;
+	try
+	{
+		if (size >= 4 && data[0] == 'P' && data[1] == 'K' && (data[2] == 3 || data[2] == 5))
+		{
+			format = ZIP;
+			listZip();
+		}
+		else if (size >= 2 && data[0] == 0x1F && data[1] == 0x8B)
+		{
+			// a gzip file holds either a tar archive or a single file
+			HeadSink head(512);
+			gunzip(data, size, head);
+			if (head.data.size() == 512 && head.data.compare(257, 5, "ustar") == 0)
+			{
+				format = TAR_GZIP;
+				listTar(true);
+			}
+			else
+			{
+				format = GZIP;
+				Member member;
+				member.name = gzipName(data, size);
+				if (member.name.empty())
+				{
+					member.name = filename.substr(filename.find_last_of("/\\") + 1);
+					if (member.name.size() > 3 && member.name.compare(member.name.size() - 3, 3, ".gz") == 0)
+						member.name.erase(member.name.size() - 3);
+				}
+				member.offset = member.compressedSize = member.size = 0;
+				member.method = 8;
+				member.crc = 0;
+				members.push_back(member);
+			}
+		}
+		else if (size >= 512 && memcmp(data + 257, "ustar", 5) == 0)
+		{
+			format = TAR;
+			listTar(false);
+		}
+		else
+			throw string("not a zip, gzip or tar archive");
+	}
+	catch (const string &msg)
+	{
+		error = filename + ": " + msg;
+		return false;
+	}
+	return true;
+}
+
+
+void * Archive::producerThread(void * arg)
+{
+	Producer * producer = (Producer *)arg;
+	try
+	{
+		producer->archive->produce(*producer);
+	}
+	catch (const string &msg)
+	{
+		producer->error = producer->archive->filename + ": " + msg;
+	}
+	for (unsigned i=0; i < producer->fds.size(); i++)
+		closePipe(producer->fds[i]);
+	return 0;
+}
+
+void Archive::produce(Producer &producer)
+{
+	const unsigned char * data = (const unsigned char *)file.data;
+	size_t size = file.size;
+
+	if (format == ZIP)
+	{
+		for (unsigned i=0; i < producer.members.size(); i++)
+		{
+			const Member &member = members[producer.members[i]];
+			if (member.offset + 30 > size || readU32(data + member.offset) != 0x04034B50)
+				throw string("invalid zip local header of ") + member.name;
+			unsigned long long start = member.offset + 30 + readU16(data + member.offset + 26) + readU16(data + member.offset + 28);
+			if (start > size || member.compressedSize > size - start)
+				throw string("truncated zip member ") + member.name;
+
+			PipeSink sink(producer.fds[i]);
+			unsigned long crc = member.crc;
+			if (member.method == 0)
+			{
+				crc = crc32(0, data + start, (size_t)member.size);
+				sink.write(data + start, (size_t)member.size);
+			}
+			else if (member.method == 8)
+			{
+				if (inflate(data + start, (size_t)member.compressedSize, sink, &crc) == 0)
+					crc = member.crc;				// the parser stopped reading
+			}
+			else
+				throw string("unsupported compression method or encryption of ") + member.name;
+			if (crc != member.crc)
+				throw string("CRC error in ") + member.name;
+			closePipe(producer.fds[i]);
+		}
+	}
+	else if (format == GZIP)
+	{
+		PipeSink sink(producer.fds[0]);
+		gunzip(data, size, sink);
+	}
+	else
+	{
+		TarWalker walker;
+		for (unsigned i=0; i < producer.members.size(); i++)
+		{
+			walker.targets[producer.members[i]] = producer.fds[i];
+			producer.fds[i] = -1;					// closed by the walker
+		}
+		if (format == TAR_GZIP)
+			gunzip(data, size, walker);
+		else
+			walker.write(data, size);
+	}
+}
+
+
+void Archive::stream(const vector<unsigned> &selected, vector<FILE *> &files)
+{
+#ifdef __linux__
+	signal(SIGPIPE, SIG_IGN);			// a parser may stop reading before the end of its member
+#endif
+	// zip members are decompressed concurrently, a tar stream only in sequence
+	Producer * producer = 0;
+	for (unsigned i=0; i < selected.size(); i++)
+	{
+		if (producer == 0 || format == ZIP)
+		{
+			producer = new Producer;
+			producer->archive = this;
+			producer->isStarted = false;
+			producers.push_back(producer);
+		}
+		int fds[2];
+		FILE * f = 0;
+		if (createPipe(fds))
+		{
+			f = openPipe(fds[0]);
+			producer->members.push_back(selected[i]);
+			producer->fds.push_back(fds[1]);
+		}
+		if (f == 0)
+			error = "cannot create pipe for " + members[selected[i]].name;
+		files.push_back(f);
+	}
+	for (unsigned i=0; i < producers.size(); i++)
+	{
+		producers[i]->isStarted = (pthread_create(&producers[i]->thread, 0, producerThread, producers[i]) == 0);
+		if (!producers[i]->isStarted)
+		{
+			producers[i]->error = "cannot create decompression thread";
+			for (unsigned k=0; k < producers[i]->fds.size(); k++)
+				closePipe(producers[i]->fds[k]);
+		}
+	}
+}
+
+
+bool Archive::finish()
+{
+	for (unsigned i=0; i < producers.size(); i++)
+	{
+		if (producers[i]->isStarted)
+			pthread_join(producers[i]->thread, 0);
+		if (error.empty())
+			error = producers[i]->error;
+		delete producers[i];
+	}
+	producers.clear();
+	return error.empty();
+}
+
+
+// Wildcard match of /name to /pattern, '*' matches any characters and '?' a single character.
+bool Archive::match(const char * pattern, const char * name)
+{
+	while (*pattern)
+	{
+		if (*pattern == '*')
+		{
+			for (const char * n = name; ; n++)
+			{
+				if (match(pattern + 1, n))
+					return true;
+				if (*n == 0)
+					return false;
+			}
+		}
+		if (*name == 0 || (*pattern != '?' && *pattern != *name))
+			return false;
+		pattern++;
+		name++;
+	}
+	return *name == 0;
+}
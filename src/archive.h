@@ -0,0 +1,74 @@
+/*	Streaming of Gerber files out of zip, gzip and tar archives.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+#ifndef ARCHIVE_H_
+#define ARCHIVE_H_
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "mappedfile.h"
+
+// An archive file (.zip, .gz, .tar.gz / .tgz or .tar) mapped into memory.
+// The members are decompressed by background threads into pipes, so that they are
+// parsed while being decompressed and never written to disk.
+class Archive
+{
+	public:
+		enum Format { ZIP, GZIP, TAR_GZIP, TAR };
+		struct Member
+		{
+			std::string name;
+			unsigned long long offset;			// of the zip local header
+			unsigned long long compressedSize;
+			unsigned long long size;
+			int method;							// zip compression method
+			unsigned long crc;
+		};
+		Format format;
+		std::vector<Member> members;			// regular files, in archive order
+		std::string error;
+
+		Archive();
+		~Archive();
+		bool open(const char * filename);		// returns false and sets error if not readable or not an archive
+		// Starts decompressing the /selected members, given in archive order, and returns
+		// a stream to read each of them in /files, or 0 if it cannot be created. Every stream
+		// must be closed by the reader.
+		void stream(const std::vector<unsigned> &selected, std::vector<FILE *> &files);
+		bool finish();							// waits for the decompression, returns false and sets error on failure
+
+		static bool match(const char * pattern, const char * name);	// wildcard match with '*' and '?'
+
+	private:
+		Archive(const Archive &);
+		Archive & operator=(const Archive &);
+
+		struct Producer;
+		static void * producerThread(void * producer);
+		void produce(Producer &producer);
+		void listZip();
+		void listTar(bool isCompressed);
+
+		MappedFile file;
+		std::string filename;
+		std::vector<Producer *> producers;
+};
+
+
+#endif  // ARCHIVE_H_
@@ -0,0 +1,197 @@
+/*	Binary display list of a parsed Gerber layer.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <map>
+#include <vector>
+
+#include "gerber.h"
+#include "displaylist.h"
+
+using namespace std;
+
+
+//--------------------------------------------------------------------------------------------------
+// Write the polygons of this parsed file to a display list file.
+// Returns false with the reason in errorMessage if the file cannot be written.
+//--------------------------------------------------------------------------------------------------
+bool Gerber::saveDisplayList(const char * filename)
+{
+	DisplayListHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, DISPLAY_LIST_MAGIC, sizeof(header.magic));
+	header.byteOrder = DISPLAY_LIST_BYTE_ORDER;
+	header.version = DISPLAY_LIST_VERSION;
+	header.dotsPerInch = dotsPerInch;
+	header.growInches = growSize / dotsPerInch;
+	header.scaleX = optScaleX;
+	header.scaleY = optScaleY;
+	header.imagePolarityDark = imagePolarityDark;
+
+	// every vertex set is written once, however many polygons use it
+	map<const VertexData *, unsigned long long> sets;
+	vector<DisplayListVertexSet> vertexSets;
+	vector<DisplayListVertex> vertices;
+	vector<DisplayListArc> arcs;
+	vector<DisplayListPolygon> records;
+	records.reserve(polygons.size());
+	for (list<Polygon>::const_iterator it = polygons.begin(); it != polygons.end(); it++)
+	{
+		map<const VertexData *, unsigned long long>::iterator set = sets.find(it->vdata);
+		if (set == sets.end())
+		{
+			set = sets.insert(make_pair(it->vdata, (unsigned long long)vertexSets.size())).first;
+			DisplayListVertexSet s = { vertices.size(), it->vdata->vertices.size(), arcs.size(), it->vdata->arcs.size() };
+			vertexSets.push_back(s);
+			for (unsigned i=0; i < it->vdata->vertices.size(); i++)
+			{
+				DisplayListVertex v = { it->vdata->vertices[i].x, it->vdata->vertices[i].y };
+				vertices.push_back(v);
+			}
+			for (unsigned i=0; i < it->vdata->arcs.size(); i++)
+			{
+				const ArcSegment &arc = it->vdata->arcs[i];
+				DisplayListArc a = { arc.vertex, arc.centre.x, arc.centre.y, arc.radius, arc.isClockwise, 0 };
+				arcs.push_back(a);
+			}
+		}
+		DisplayListPolygon p = { set->second, it->offset.x, it->offset.y, it->polarity, it->number };
+		records.push_back(p);
+	}
+	header.vertexSetCount = vertexSets.size();
+	header.vertexCount = vertices.size();
+	header.polygonCount = records.size();
+	header.arcCount = arcs.size();
+	header.vertexSetOffset = sizeof(header);
+	header.vertexOffset = header.vertexSetOffset + vertexSets.size() * sizeof(DisplayListVertexSet);
+	header.arcOffset = header.vertexOffset + vertices.size() * sizeof(DisplayListVertex);
+	header.polygonOffset = header.arcOffset + arcs.size() * sizeof(DisplayListArc);
+
+	FILE * fp = 0;
+#ifndef __linux__
+	fopen_s(&fp, filename, "wb");
+#else
+	fp = fopen(filename, "wb");
+#endif
+	bool isWritten = (fp != 0);
+	if (fp)
+	{
+		isWritten = fwrite(&header, sizeof(header), 1, fp) == 1;
+		if (isWritten && !vertexSets.empty())
+			isWritten = fwrite(&vertexSets[0], sizeof(DisplayListVertexSet), vertexSets.size(), fp) == vertexSets.size();
+		if (isWritten && !vertices.empty())
+			isWritten = fwrite(&vertices[0], sizeof(DisplayListVertex), vertices.size(), fp) == vertices.size();
+		if (isWritten && !arcs.empty())
+			isWritten = fwrite(&arcs[0], sizeof(DisplayListArc), arcs.size(), fp) == arcs.size();
+		if (isWritten && !records.empty())
+			isWritten = fwrite(&records[0], sizeof(DisplayListPolygon), records.size(), fp) == records.size();
+		if (fclose(fp) != 0)
+			isWritten = false;
+	}
+	if (!isWritten)
+		errorMessage << "error: cannot write display list " << filename;
+	return isWritten;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Create the polygons from a display list held in memory, e.g. a memory mapped file, instead of
+// parsing a Gerber file. The records are used in place, only the vertices and arcs are copied to
+// the VertexData objects, scaled when rendering at another resolution.
+// Errors are reported through isError and errorMessage, as for a parsed file.
+//--------------------------------------------------------------------------------------------------
+Gerber * Gerber::loadDisplayList(const char * data, size_t length, double dotsPerInch, double growSize, double optScaleX, double optScaleY)
+{
+	Gerber * g = new Gerber(dotsPerInch, growSize, optScaleX, optScaleY, PARSE_RENDER, 0);
+	try
+	{
+		if (!isDisplayList(data, length))
+			throw string("not a display list");
+		const DisplayListHeader * header = (const DisplayListHeader *)data;
+		if (header->byteOrder != DISPLAY_LIST_BYTE_ORDER)
+			throw string("display list written on a machine of another byte order");
+		if (header->version != DISPLAY_LIST_VERSION)
+			throw string("unsupported display list version");
+		if (header->vertexSetOffset % 8 || header->vertexOffset % 8 || header->arcOffset % 8 || header->polygonOffset % 8
+				|| header->vertexSetOffset > length || (length - header->vertexSetOffset) / sizeof(DisplayListVertexSet) < header->vertexSetCount
+				|| header->vertexOffset > length || (length - header->vertexOffset) / sizeof(DisplayListVertex) < header->vertexCount
+				|| header->arcOffset > length || (length - header->arcOffset) / sizeof(DisplayListArc) < header->arcCount
+				|| header->polygonOffset > length || (length - header->polygonOffset) / sizeof(DisplayListPolygon) < header->polygonCount)
+			throw string("truncated display list");
+		if (header->scaleX != optScaleX || header->scaleY != optScaleY
+				|| fabs(header->growInches - growSize / dotsPerInch) > 1e-9)
+			throw string("display list made with other --scale or --grow options, parse the gerber file instead");
+
+		const DisplayListVertexSet * sets = (const DisplayListVertexSet *)(data + header->vertexSetOffset);
+		const DisplayListVertex * vertices = (const DisplayListVertex *)(data + header->vertexOffset);
+		const DisplayListArc * arcs = (const DisplayListArc *)(data + header->arcOffset);
+		const DisplayListPolygon * records = (const DisplayListPolygon *)(data + header->polygonOffset);
+		double factor = dotsPerInch / header->dotsPerInch;
+		g->imagePolarityDark = header->imagePolarityDark != 0;
+
+		vector<VertexData *> vdata(header->vertexSetCount);
+		for (unsigned long long i=0; i < header->vertexSetCount; i++)
+		{
+			if (sets[i].firstVertex > header->vertexCount || header->vertexCount - sets[i].firstVertex < sets[i].vertexCount
+					|| sets[i].firstArc > header->arcCount || header->arcCount - sets[i].firstArc < sets[i].arcCount)
+				throw string("invalid vertex set in display list");
+			vdata[i] = new VertexData;
+			g->vertexdata.push_back(vdata[i]);
+			const DisplayListVertex * v = vertices + sets[i].firstVertex;
+			vdata[i]->vertices.resize((size_t)sets[i].vertexCount);
+			for (unsigned long long k=0; k < sets[i].vertexCount; k++)
+				vdata[i]->vertices[(size_t)k] = (factor == 1) ? Point(v[k].x, v[k].y) : Point(v[k].x * factor, v[k].y * factor);
+			const DisplayListArc * a = arcs + sets[i].firstArc;
+			vdata[i]->arcs.resize((size_t)sets[i].arcCount);
+			for (unsigned long long k=0; k < sets[i].arcCount; k++)
+			{
+				// arcs end on a vertex after the first, in ascending order
+				if (a[k].vertex == 0 || a[k].vertex >= sets[i].vertexCount || (k > 0 && a[k].vertex <= a[k-1].vertex))
+					throw string("invalid arc in display list");
+				ArcSegment &arc = vdata[i]->arcs[(size_t)k];
+				arc.vertex = (size_t)a[k].vertex;
+				arc.centre = Point(a[k].centreX * factor, a[k].centreY * factor);
+				arc.radius = a[k].radius * factor;
+				arc.isClockwise = a[k].isClockwise != 0;
+			}
+			vdata[i]->initialiseExtents();
+		}
+
+		Polygon polygon;
+		delete polygon.vdata;
+		for (unsigned long long i=0; i < header->polygonCount; i++)
+		{
+			if (records[i].vertexSet >= header->vertexSetCount)
+				throw string("invalid polygon in display list");
+			polygon.vdata = vdata[(size_t)records[i].vertexSet];
+			polygon.offset = Point(records[i].offsetX * factor, records[i].offsetY * factor);
+			polygon.polarity = Polarity_t(records[i].polarity);
+			polygon.number = records[i].number;
+			g->polygons.push_back(polygon);
+			g->polygons.back().initialise();
+		}
+		g->polygons.sort();
+	}
+	catch (const string& msg)
+	{
+		g->isError = true;
+		g->errorMessage << "error: " << msg;
+	}
+	return g;
+}
@@ -0,0 +1,104 @@
+/*	Binary display list of a parsed Gerber layer.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+#ifndef DISPLAYLIST_H_
+#define DISPLAYLIST_H_
+
+#include <stddef.h>
+
+// A display list holds the polygons of a parsed Gerber file, so that it can be rendered again
+// without parsing. The file is a header followed by four tables of fixed size records, each
+// starting at an 8 byte aligned offset, so that it is used directly from a memory mapping:
+//
+//   vertex sets	the vertices of each shape, shared by all polygons drawn with it (flashes of an aperture)
+//   vertices		x, y of all vertex sets, in pixels at the resolution of the header
+//   arcs			edges of the vertex sets that are circular arcs, see ArcSegment
+//   polygons		instances of the vertex sets with their offset, polarity and drawing order
+//
+// Coordinates are scaled by the ratio of the resolutions when rendered at another DPI.
+
+static const char DISPLAY_LIST_MAGIC[8] = { 'G', '2', 'P', 'D', 'L', 'S', 'T', 0 };
+static const unsigned DISPLAY_LIST_VERSION = 2;
+static const unsigned DISPLAY_LIST_BYTE_ORDER = 0x01020304;
+
+struct DisplayListHeader
+{
+	char magic[8];
+	unsigned byteOrder;							// DISPLAY_LIST_BYTE_ORDER in the byte order of the writer
+	unsigned version;
+	double dotsPerInch;							// resolution of the coordinates
+	double growInches;							// --grow option the file was parsed with
+	double scaleX;								// --scale-x and --scale-y options the file was parsed with
+	double scaleY;
+	unsigned imagePolarityDark;
+	unsigned reserved;
+	unsigned long long vertexSetCount;
+	unsigned long long vertexCount;
+	unsigned long long polygonCount;
+	unsigned long long vertexSetOffset;			// file offsets of the tables
+	unsigned long long vertexOffset;
+	unsigned long long polygonOffset;
+	unsigned long long arcCount;
+	unsigned long long arcOffset;
+};
+
+struct DisplayListVertexSet
+{
+	unsigned long long firstVertex;
+	unsigned long long vertexCount;
+	unsigned long long firstArc;
+	unsigned long long arcCount;
+};
+
+struct DisplayListVertex
+{
+	double x;
+	double y;
+};
+
+struct DisplayListArc
+{
+	unsigned long long vertex;					// in the vertex set, the arc ends on it
+	double centreX;
+	double centreY;
+	double radius;
+	int isClockwise;
+	int reserved;
+};
+
+struct DisplayListPolygon
+{
+	unsigned long long vertexSet;
+	double offsetX;
+	double offsetY;
+	int polarity;								// Polarity_t
+	int number;									// drawing order
+};
+
+// Returns true if the data starts with a display list header
+inline bool isDisplayList(const char * data, size_t length)
+{
+	if (length < sizeof(DisplayListHeader))
+		return false;
+	for (int i=0; i < 8; i++)
+		if (data[i] != DISPLAY_LIST_MAGIC[i])
+			return false;
+	return true;
+}
+
+
+#endif  // DISPLAYLIST_H_
@@ -24,8 +24,13 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #include <vector>
 #include <list>
+#include <map>
 #include <stdio.h>
 #include <math.h>
+#ifndef __linux__
+#define HAVE_STRUCT_TIMESPEC
+#endif
+#include <pthread.h>
 
 #pragma hdrstop
 using namespace::std;
@@ -39,12 +44,14 @@ using namespace::std;
 #include "corecrt_math_defines.h"
 #endif
 
-void yyerror( Gerber *g, const char * bisonMessage)
+void yyerror( Gerber *g, void *scanner, const char * bisonMessage)
 {
 	string str = bisonMessage;
     size_t found = str.find("$undefined");			// replace the "$undefined" word in bison error string
+    if (found==string::npos)
+    	found = str.find("invalid token");			// newer bison versions use this name instead
     if (found!=string::npos)
-    	str.replace(found, string::npos, "'" + string(yytext) + "'");
+    	str.replace(found, string::npos, "'" + string(yyget_text(scanner)) + "'");
 	throw (str);
 }
 
@@ -125,29 +132,260 @@ double Gerber::dotsPerUnit()
 }
 
 
+//
+// Apply the load mirroring, scaling and rotation, in this order, to a point in pixel units.
+// The pixel Y axis is inverted relative to the Gerber Y axis, unless mirrored by MI.
+//
+Point Gerber::loadTransform(Point P)
+{
+	if (isLoadMirrorX)	P.x = -P.x;
+	if (isLoadMirrorY)	P.y = -P.y;
+	P = P * loadScale;
+	P.rotate((scaleFactor[0] * scaleFactor[1] > 0) ? -loadRotation : loadRotation);
+	return P;
+}
+
+bool Gerber::TransformKey::operator<(const TransformKey &rhs) const
+{
+	if (vdata != rhs.vdata)				return vdata < rhs.vdata;
+	if (isMirrorX != rhs.isMirrorX)		return isMirrorX < rhs.isMirrorX;
+	if (isMirrorY != rhs.isMirrorY)		return isMirrorY < rhs.isMirrorY;
+	if (rotation != rhs.rotation)		return rotation < rhs.rotation;
+	return scale < rhs.scale;
+}
+
+//
+// Returns the vertices of an aperture polygon with the current load transformation applied.
+// They are made on the first flash with this aperture and transformation, then shared by all
+// the following flashes, so a part placed many times at the same orientation is transformed once.
+//
+VertexData * Gerber::transformVertices(VertexData * source)
+{
+	TransformKey key = { source, isLoadMirrorX, isLoadMirrorY, loadRotation, loadScale };
+	VertexData * &vdata = transformedVertices[key];
+	if (vdata == 0)
+	{
+		vdata = new VertexData;
+		vdata->vertices.reserve(source->vertices.size());
+		for (unsigned i=0; i < source->vertices.size(); i++)
+			vdata->vertices.push_back( loadTransform(source->vertices[i]) );
+		vdata->arcs = source->arcs;
+		for (unsigned i=0; i < vdata->arcs.size(); i++)
+		{
+			ArcSegment &arc = vdata->arcs[i];
+			arc.centre = loadTransform(arc.centre);
+			arc.radius *= fabs(loadScale);
+			if (isLoadMirrorX != isLoadMirrorY)
+				arc.isClockwise = !arc.isClockwise;
+		}
+		vertexdata.push_back(vdata);		// rotated by IR and initialised with the other vertices
+	}
+	return vdata;
+}
+
+
 //
 // Flash Aperture. Adds the polygon of the currently selected aperture to the polygon list, including sub aperture.
+// Polygons of block apertures keep their position relative to the block origin.
 //
 void Gerber::flashAperture(double x, double y)
 {
+	if (apertureSelect->isDropped)
+		return;
+	if (!isGeometryEnabled)
+	{
+		if (mode == PARSE_LINT)
+			addFlashExtents(x, y);
+		return;
+	}
+	bool isTransformed = isLoadTransformed();
 	// Aperture::composite points to aperture in the link list that must be plotted in succession.
-	Aperture * arp = &*(apertureSelect);
+	Aperture * arp = apertureSelect;
 	while (arp)
 	{
 		for (list<Polygon>::iterator it = arp->polygons.begin(); it != arp->polygons.end(); it++)
 		{
 			polygons.push_back( *it ); // Copy polygon from aperture
-			polygons.back();
-			polygons.back().offset.x = x * scaleFactor[0];
-			polygons.back().offset.y = - y * scaleFactor[1];
+			if (isTransformed)
+			{
+				polygons.back().vdata = transformVertices(it->vdata);
+				polygons.back().offset = loadTransform(it->offset);
+			}
+			polygons.back().offset.x += x * scaleFactor[0];
+			polygons.back().offset.y += - y * scaleFactor[1];
 			// invert all sub polygons polarity when %PLC*% parameter specified.
-			if (layerPolarityClear) { polygons.back().polarity = CLEAR; }
+			// A block flashed with clear polarity has the polarity of all its objects toggled.
+			if (layerPolarityClear)
+				polygons.back().polarity = (arp->primitive == Aperture::BLOCK && it->polarity == CLEAR) ? DARK : CLEAR;
 		}
 		arp = arp->composite;
 	}
 }
 
 
+//
+// Lint mode. The extents of the image are computed from the coordinates and the aperture extents
+// instead of building polygons. Points are in the unscaled pixel coordinates of X, Y.
+//
+void Gerber::addExtents(double x, double y)
+{
+	extents.add(Point(x * scaleFactor[0], - y * scaleFactor[1]));
+}
+
+void Gerber::addFlashExtents(double x, double y)
+{
+	Aperture * head = apertureSelect;
+	if (head->extents.empty())
+		for (Aperture * arp = head; arp; arp = arp->composite)
+			for (list<Polygon>::iterator it = arp->polygons.begin(); it != arp->polygons.end(); it++)
+			{
+				for (unsigned i=0; i < it->vdata->vertices.size(); i++)
+					head->extents.add(it->vdata->vertices[i] + it->offset);
+				for (unsigned i=0; i < it->vdata->arcs.size(); i++)
+				{
+					Point points[6];
+					int n = it->vdata->arcPoints(i, 0, M_PI/2, points);
+					for (int k=1; k < n - 1; k++)
+						head->extents.add(points[k] + it->offset);
+				}
+			}
+	if (head->extents.empty())
+		return;
+	bool isTransformed = isLoadTransformed();
+	Point position(x * scaleFactor[0], - y * scaleFactor[1]);
+	for (int i=0; i < 4; i++)
+	{
+		Point P = head->extents.corner(i);
+		if (isTransformed)
+			P = loadTransform(P);
+		extents.add(P + position);
+	}
+}
+
+// Adds the points of an arc where it crosses the axes through its centre, widened by halfWidth.
+// The end points are added by the caller.
+void Gerber::addArcExtents(const Arc &arc, double halfWidth, bool isClockwise)
+{
+	double start = isClockwise ? arc.end : arc.start;		// sweep anticlockwise from start
+	double sweep = isClockwise ? arc.start - arc.end : arc.end - arc.start;
+	while (sweep <= 0)		sweep += 2*M_PI;
+	while (sweep > 2*M_PI)	sweep -= 2*M_PI;
+	for (int k=0; k < 4; k++)
+	{
+		double angle = fmod(k * M_PI/2 - start, 2*M_PI);
+		if (angle < 0)
+			angle += 2*M_PI;
+		if (angle <= sweep)
+			addExtents(arc.centre.x + (arc.radius + halfWidth) * cos(k * M_PI/2), arc.centre.y + (arc.radius + halfWidth) * sin(k * M_PI/2));
+	}
+}
+
+
+//
+// Step and Repeat. Closes the current %SR block by adding instances of its polygons at every step,
+// then opens a new block when more than one copy is requested. An instance is a copy of the Polygon
+// record with a different offset, the vertices and scan line data are shared with the block polygon.
+//
+void Gerber::stepRepeat(int countX, int countY, double stepI, double stepJ)
+{
+	size_t count = (polygons.size() > repeat.firstPolygon) ? polygons.size() - repeat.firstPolygon : 0;
+	if (isGeometryEnabled && (repeat.X > 1 || repeat.Y > 1) && count > 0)
+	{
+		list<Polygon>::iterator first = polygons.end();
+		while (count--)
+			first--;
+		list<Polygon>::iterator last = --polygons.end();
+		for (int i=0; i < repeat.X; i++)
+			for (int j=0; j < repeat.Y; j++)
+			{
+				if (i == 0 && j == 0)	continue;		// the block itself
+				Point step(i * repeat.I * scaleFactor[0], - j * repeat.J * scaleFactor[1]);
+				list<Polygon>::iterator it = first;
+				do
+				{
+					polygons.push_back( *it );
+					polygons.back().offset = polygons.back().offset + step;
+				} while (it++ != last);
+			}
+	}
+	if (mode == PARSE_LINT && (repeat.X > 1 || repeat.Y > 1))
+	{
+		Extents block = extents;
+		extents = repeat.extentsBefore;
+		extents.add(block);
+		Point step((repeat.X - 1) * repeat.I * scaleFactor[0], - (repeat.Y - 1) * repeat.J * scaleFactor[1]);
+		if (!block.empty())
+			for (int i=0; i < 4; i++)
+				extents.add(block.corner(i) + step);
+	}
+
+	repeat.X = max(countX, 1);
+	repeat.Y = max(countY, 1);
+	repeat.I = repeat.J = 0;
+	if (repeat.X > 1 || repeat.Y > 1)
+	{
+		repeat.I = stepI * dotsPerUnit();
+		repeat.J = stepJ * dotsPerUnit();
+		if (mode == PARSE_LINT)
+		{
+			repeat.extentsBefore = extents;		// the extents of the block are collected on their own
+			extents = Extents();
+		}
+	}
+	repeat.firstPolygon = polygons.size();
+}
+
+
+//
+// Block aperture %ABDnn*%. The objects up to the matching %AB*% are not drawn, they make up aperture Dnn.
+// Their geometry is built also while pre-scanning a file, as the aperture may be flashed from any chunk.
+//
+void Gerber::beginBlockAperture(int DCode)
+{
+	if (DCode < 10)
+		throw string("block aperture D code must be >= 10");
+	BlockAperture block;
+	block.DCode = DCode;
+	block.firstPolygon = polygons.size();
+	block.isGeometryEnabled = isGeometryEnabled;
+	openBlocks.push_back(block);
+	isGeometryEnabled = true;
+}
+
+void Gerber::endBlockAperture()
+{
+	if (openBlocks.empty())
+		throw string("%AB*% found without an open block aperture");
+	if (isPolygonFill)
+		throw string("block aperture closed inside a G36/G37 region");
+	BlockAperture block = openBlocks.back();
+	openBlocks.pop_back();
+	isGeometryEnabled = block.isGeometryEnabled;
+
+	//if aperture D code has already been defined then replace it
+	Aperture *arp = findAperture(block.DCode);
+	if (arp == 0)
+	{
+		ad_apertures.push_back(Aperture());
+		arp = &ad_apertures.back();
+		setAperture(block.DCode, arp);
+	}
+	*arp = Aperture();
+	arp->primitive = Aperture::BLOCK;
+	arp->DCode = block.DCode;
+	arp->linenum_at_definition = currentLine;
+	arp->attributes = apertureAttributes;		// the objects of the block have been filtered by their own apertures
+
+	// move the block polygons from the image to the aperture
+	list<Polygon>::iterator first = polygons.end();
+	for (size_t count = polygons.size() - block.firstPolygon; count > 0; count--)
+		first--;
+	arp->polygons.splice(arp->polygons.end(), polygons, first, polygons.end());
+	if (lastDrawnApertureSelect == arp)
+		lastDrawnApertureSelect = 0;
+}
+
+
 
 
 /*
@@ -240,12 +478,36 @@ void Gerber::calculateArc(Arc &arc)
 
 
 
+// Precalculate the factors converting integer Gerber coordinates to pixels for the current
+// %FS format and %MO units. With trailing zeroes omitted the divisor depends on the number of digits.
+void Gerber::updateCoordinateFormat()
+{
+	coordFormat.dotsPerUnit = dotsPerUnit();		// may warn about missing units and set them
+	coordFormat.units = units;
+	coordFormat.isOmitLeadingZeroes = isOmitLeadingZeroes;
+	for (int axis=0; axis < 2; axis++)
+	{
+		coordFormat.ints[axis] = coordsInts[axis];
+		coordFormat.decimals[axis] = coordsDecimals[axis];
+		for (int digits=0; digits <= MAX_COORD_DIGITS; digits++)
+		{
+			if (isOmitLeadingZeroes)
+				coordFormat.divisor[axis][digits] = pow(10, double(coordsDecimals[axis]));
+			else
+				coordFormat.divisor[axis][digits] = pow(10, double(digits - coordsInts[axis]));
+		}
+	}
+}
+
+
 // Gets coordinated value an formatted RS274X coordinate string contained in /text.
 // Returns coordinate value pixel units.
 // If is_I_J is true then the coordinate data is for I J, and is therefore absolute,
 //  and unaffected by image offset parameter.
 //  This function is called from yylex() on any X, Y, I, J commands, and shall enable
 //  the drawing
+// The digits are decoded to an exact 64 bit integer in Gerber units, then converted to pixels with
+// the factors of coordFormat, so no floating point parsing or pow() is done per coordinate.
 double Gerber::getCoordinate( char * text, int axis, bool is_I_J)
 {
 	isDrawingEnabled = true;	// any X, Y, I, J command shall enable the drawing
@@ -258,22 +520,30 @@ double Gerber::getCoordinate( char * text, int axis, bool is_I_J)
 		isOmitLeadingZeroes = true;
 		isCoordsAbsolute = true;
 	}
+	if (units != coordFormat.units || isOmitLeadingZeroes != coordFormat.isOmitLeadingZeroes
+			|| coordsInts[axis] != coordFormat.ints[axis] || coordsDecimals[axis] != coordFormat.decimals[axis])
+		updateCoordinateFormat();
 
-	int maxdigits = coordsDecimals[axis] + coordsInts[axis];
-
-	double value = atoi(text);
+	bool isNegative = (text[0] == '-');
 	if (text[0] == '-' || text[0] == '+')  text++;
 
-	int excess_digits = (int)strlen(text) - (coordsDecimals[axis] + coordsInts[axis]);
+	long long integer = 0;
+	int digits = 0;
+	for (; text[digits] >= '0' && text[digits] <= '9'; digits++)
+	{
+		if (digits < MAX_COORD_DIGITS)
+			integer = integer * 10 + (text[digits] - '0');
+	}
+
+	int excess_digits = digits - (coordsDecimals[axis] + coordsInts[axis]);
 	if (excess_digits > 0)
 		warning("found %d surplus digits in coordinate ",excess_digits);
+	if (digits > MAX_COORD_DIGITS)
+		digits = MAX_COORD_DIGITS;
 
-	if (isOmitLeadingZeroes)
-		value /= pow(10, double(coordsDecimals[axis]));
-	else
-		value /= pow(10, double( (int)strlen(text) - coordsInts[axis]));		// bug fixed: added int cast to strlen()
-
-	value *= dotsPerUnit();						// convert to pixels
+	double value = double(isNegative ? -integer : integer);
+	value /= coordFormat.divisor[axis][digits];
+	value *= coordFormat.dotsPerUnit;			// convert to pixels
 	if (!is_I_J)
 		value += imageOffsetPixels[axis];		// Offset adjustment,
 
@@ -287,29 +557,86 @@ double Gerber::getCoordinate( char * text, int axis, bool is_I_J)
 
 
 
+// D-codes below this value are held in the dense apertureTable, larger ones in apertureTableLarge.
+static const int MAX_DENSE_DCODE = 1<<16;
+
+// Returns the aperture defined for /DCode, or 0 when it has not been defined.
+Aperture * Gerber::findAperture(int DCode)
+{
+	if (DCode >= 0 && DCode < (int)apertureTable.size())
+		return apertureTable[DCode];
+	if (DCode < MAX_DENSE_DCODE)
+		return 0;
+	map<int, Aperture *>::iterator it = apertureTableLarge.find(DCode);
+	return (it == apertureTableLarge.end()) ? 0 : it->second;
+}
+
+void Gerber::setAperture(int DCode, Aperture * arp)
+{
+	if (DCode < 0)
+		return;
+	if (DCode >= MAX_DENSE_DCODE)
+	{
+		apertureTableLarge[DCode] = arp;
+		return;
+	}
+	if (DCode >= (int)apertureTable.size())
+		apertureTable.resize(DCode + 1, 0);
+	apertureTable[DCode] = arp;
+}
+
+
+
+//--------------------------------------------------------------------------------------------------
+// Compile the macro aperture just defined by an %AM block. The parameter expressions of all its
+// primitives go into one MacroProgram, so an %AD instantiation evaluates them in a single run.
+//--------------------------------------------------------------------------------------------------
+void Gerber::compileMacro()
+{
+	MacroProgram * program = new MacroProgram;
+	list<Aperture>::iterator first = macro_apertures.end();
+	while (first != macro_apertures.begin())
+	{
+		list<Aperture>::iterator prev = first;
+		prev--;
+		if (prev->program || prev->nameMacro != temporaryNameMacro)
+			break;
+		first = prev;
+	}
+	for (list<Aperture>::iterator it = first; it != macro_apertures.end(); it++)
+	{
+		it->program = program;
+		it->firstParameter = program->parameterCount;
+		it->parameterCount = it->parameter.size();
+		for (int i=0; i < it->parameter.size(); i++)
+		{
+			program->compile(it->parameter[i]);
+			delete it->parameter[i];
+		}
+		it->parameter.clear();
+	}
+}
+
+
+
 //--------------------------------------------------------------------------------------------------
 //						Process AD data block
 //--------------------------------------------------------------------------------------------------
 void Gerber::process_AD_block(int DCode)
 {
 	int   composite_count = 0;
-	Aperture *arp = 0;
+	MacroValues values;
+	const MacroProgram * program = 0;			// the program values were evaluated with
 
 	//if aperture D code has already been defined then replace it
-	for (list<Aperture>::iterator it = ad_apertures.begin();  it != ad_apertures.end(); it++)
-	{
-		if (it->DCode == DCode)
-		{
-			arp = &(*it);
-			break;
-		}
-	}
+	Aperture *arp = findAperture(DCode);
 	// Create a new aperture object for this AD code.
 	if (arp == 0)
 	{
 		ad_apertures.push_back(Aperture());				// blank aperture
 		arp = &ad_apertures.back();
 	}
+	Aperture *head = arp;						// first primitive, selected by the D-code
 
 
 
@@ -341,17 +668,39 @@ void Gerber::process_AD_block(int DCode)
 		arp->DCode = DCode;						// Assigned D number found in this ADD block
 		arp->linenum_at_definition = currentLine;		// record line in Gerber file
 
+		// all primitives of a macro share one program, evaluate it once for the first primitive
+		if (amacro->program != program)
+		{
+			program = amacro->program;
+			program->run(variables, values);
+		}
+		arp->arguments = &values;
+
 		try
 		{
-			arp->render(dotsPerUnit(), growSize, variables.size() );
-			// New polygons object for this aperture have been created, we can now scale the vertices, and save pointer to new vertex data.
-			for (list<Polygon>::iterator it = arp->polygons.begin(); it != arp->polygons.end(); it++)
+			double dpu = dotsPerUnit();
+			double scale[2] = { scaleFactor[0], -scaleFactor[1] };
+			vector<double> key;
+			bool isCacheable = arp->cacheKey(dpu, growSize, variables.size(), scale, key);
+			if (!isCacheable || !ApertureCache::find(key, *arp))
 			{
-				it->vdata->scale( scaleFactor[0], -scaleFactor[1] );
-				vertexdata.push_back(it->vdata);
+				arp->render(dpu, growSize, variables.size() );
+				// New polygons object for this aperture have been created, we can now scale the vertices, and save pointer to new vertex data.
+				for (list<Polygon>::iterator it = arp->polygons.begin(); it != arp->polygons.end(); it++)
+				{
+					it->vdata->scale( scale[0], scale[1] );
+					if (!isCacheable)
+						vertexdata.push_back(it->vdata);
+				}
+				if (isCacheable)
+					ApertureCache::insert(key, *arp);
 			}
+			arp->arguments = 0;
 			if (arp->polygons.size() == 0)		// if aperture is blank then don't add it to the list
+			{
+				if (&ad_apertures.back() == head)	head = 0;
 				ad_apertures.pop_back();     	// this should never happen ???????
+			}
 		}
 		catch (string msg)
 		{
@@ -366,6 +715,12 @@ void Gerber::process_AD_block(int DCode)
 	} // end of macro name search and finished with
 
 	variables.clear();
+	setAperture(DCode, head);
+	if (head)
+	{
+		head->attributes = apertureAttributes;
+		head->isDropped = filter && !filter->isDrawn(apertureAttributes);
+	}
 
 	if (composite_count == 0)
 		{ oss << "the referring macro aperture name '" << temporaryNameMacro << "' is undefined";  throw oss.str(); }
@@ -373,6 +728,51 @@ void Gerber::process_AD_block(int DCode)
 } // end of AD command block  processing
 
 
+//
+// X2 attribute commands %TF, %TA, %TO and %TD, or the same in a "G04 #@! " comment; text starts at
+// the 'T' or the 'G'. Only the aperture attributes are kept. They are attached to the apertures
+// defined and the regions started while they are set, and select the objects drawn by filter.
+//
+void Gerber::processAttribute(const char * text)
+{
+	if (text[0] == 'G')
+	{
+		text = strstr(text, "#@!");
+		if (text == 0)
+			return;					// a plain comment
+		text += 3;
+		while (isspace(*text)) text++;
+		if (text[0] != 'T')
+			return;
+	}
+	string command;
+	for (const char * p = text + 1; *p; p++)
+		if (*p != '\r' && *p != '\n')
+			command += *p;
+	if (command.empty())
+		return;
+	size_t comma = command.find(',');
+	string name = command.substr(1, (comma == string::npos) ? string::npos : comma - 1);
+	string value = (comma == string::npos) ? string() : command.substr(comma + 1);
+	switch (command[0])
+	{
+	case 'A':	apertureAttributes[name] = value;	break;
+	case 'D':	if (name.empty())	apertureAttributes.clear();
+				else				apertureAttributes.erase(name);
+				break;
+	}
+}
+
+bool FunctionFilter::isDrawn(const map<string, string> &attributes) const
+{
+	map<string, string>::const_iterator it = attributes.find(".AperFunction");
+	string function = (it == attributes.end()) ? string() : it->second.substr(0, it->second.find(','));
+	if (exclude.count(function))
+		return false;
+	return include.empty() || include.count(function);
+}
+
+
 
 
 
@@ -395,12 +795,17 @@ void Gerber::process_G_command(int code)
 	{
 		isPolygonFill = false;
 		isDrawingEnabled = false;					// don't draw after polygon exit within current command block
-		polygons.back().vdata->scale(scaleFactor[0], -scaleFactor[1]);
+		if (isGeometryEnabled && !isRegionDropped && !polygons.empty())
+			polygons.back().vdata->scale(scaleFactor[0], -scaleFactor[1]);
+		isRegionDropped = false;
 	}
 	if ( code == 36 &&  isPolygonFill == false )	// new polygon for the current polygon fill command
 	{
 		isLampOn = false;							// Always start with lamp off so tool can be positioned after a G36 command with lamp off
 		isPolygonFill = true;
+		isRegionDropped = filter && !filter->isDrawn(apertureAttributes);	// a region has the aperture attributes set
+		if (!isGeometryEnabled || isRegionDropped)
+			return;
 		polygons.push_back(Polygon());
 		vertexdata.push_back( polygons.back().vdata ); 	// Save pointer to vertex data for the newly created Polygon
 		if (layerPolarityClear) { polygons.back().polarity = CLEAR; }	// polygon polarity dependent on PLC / PLD parameters
@@ -413,15 +818,11 @@ void Gerber::process_D_command(int code)
 {
 	if (code >= 10)
 	{
-		// search for a Aperture list with a matching D_number, use default aperture if not found.
-		apertureSelect = ad_apertures.begin();
-		apertureSelect++;
-		for (; apertureSelect != ad_apertures.end();  apertureSelect++)
-		{
-			if (code == apertureSelect->DCode ) break;
-		}
-		if (apertureSelect == ad_apertures.end()) {			// default to first in list
-			apertureSelect = ad_apertures.begin();
+		// look up the aperture with a matching D_number, use default aperture if not found.
+		apertureLookups++;
+		apertureSelect = findAperture(code);
+		if (apertureSelect == 0) {			// default to first in list
+			apertureSelect = &ad_apertures.front();
 			warning("Aperture D%d has not been defined", code);
 		}
 	}
@@ -457,22 +858,36 @@ void Gerber::processDataBlock()
 	//--------------------------------------------------------------
 	if (isLampOn && isDrawingEnabled)
 	{
-		if (isPolygonFill)	// Add vertices to polygon
+		if (isPolygonFill && isRegionDropped)
 		{
-			if (polygons.back().empty())
+			// region not drawn, its function is filtered out
+		}
+		else if (isPolygonFill)	// Add vertices to polygon
+		{
+			if (isGeometryEnabled && polygons.back().empty())
 			{
 				polygons.back().vdata->add( oldX , oldY);
 			}
+			if (!isGeometryEnabled && mode == PARSE_LINT)
+			{
+				addExtents(oldX, oldY);
+				addExtents(X, Y);
+			}
 			if ((drawingMode == CIRCLE_CLOCKWISE || drawingMode == CIRCLE_ANTICLOCKWISE) )
 			{
 				Arc arc;
 				calculateArc( arc );
-				if (! arc.isTooSmall)
-					polygons.back().vdata->addArc(arc.start, arc.end, arc.radius, arc.centre.x, arc.centre.y, (drawingMode == CIRCLE_CLOCKWISE));
+				if (! isGeometryEnabled)
+				{
+					if (mode == PARSE_LINT && !arc.isTooSmall)
+						addArcExtents(arc, 0, (drawingMode == CIRCLE_CLOCKWISE));
+				}
+				else if (! arc.isTooSmall)
+					polygons.back().vdata->addArcEdge(arc.start, arc.end, arc.radius, arc.centre.x, arc.centre.y, (drawingMode == CIRCLE_CLOCKWISE));
 				else
 					polygons.back().vdata->add( X , Y);
 			}
-			else
+			else if (isGeometryEnabled)
 			{
 				polygons.back().vdata->add( X , Y);
 			}
@@ -481,7 +896,7 @@ void Gerber::processDataBlock()
 		else 	// Draw to current tool position
 		{
 			// Warn user we are about to use default aperture
-			if (!isWarnNoApertureSelect && (apertureSelect == ad_apertures.begin()))
+			if (!isWarnNoApertureSelect && (apertureSelect == &ad_apertures.front()))
 			{
 				warning("Drawing started without aperture select. Using default");
 				isWarnNoApertureSelect = true;
@@ -497,16 +912,26 @@ void Gerber::processDataBlock()
 				throw oss.str();
 			}
 
+			// A line drawn with a round aperture is a single obround polygon including its round ends, scanned
+			// from its chords while rendering. With --grow the ends are flashed as before, grown unlike the line.
+			bool isWholeTrace = drawingMode == LINEAR_1X && toolShift > 1 && isGeometryEnabled && !apertureSelect->isDropped
+					&& apertureSelect->polygons.size() == 1 && growSize == 0;
+			bool isRoundTrace = isWholeTrace && apertureSelect->primitive == Aperture::STANDARD_CIRCLE;
+			// Likewise a horizontal or vertical line drawn with an unrotated rectangle aperture is a single rectangle
+			bool isRectangleTrace = isWholeTrace && apertureSelect->primitive == Aperture::STANDARD_RECTANGLE
+					&& loadRotation == 0 && (dX == 0 || dY == 0);
+			isWholeTrace = isRoundTrace || isRectangleTrace;
+
 			// Flash at start of line or arc if last draw was at a different position or different aperture
-			if ( lastDrawnApertureSelect != apertureSelect || lastDrawnX != oldX || lastDrawnY != oldY )
+			if ( !isWholeTrace && (lastDrawnApertureSelect != apertureSelect || lastDrawnX != oldX || lastDrawnY != oldY) )
 			{
 	//			printf("init flashed %d (%f,%f)\n",apertureSelect->DCode, oldX,oldY );
 				flashAperture(oldX, oldY);
 			}
 
 			// Get size of the circle (C) or rectangle (R) type polygon.
-			double polygon_width  = apertureSelect->standardApWidth;
-			double polygon_heigth = apertureSelect->standardApHeight;
+			double polygon_width  = apertureSelect->standardApWidth * loadScale;
+			double polygon_heigth = apertureSelect->standardApHeight * loadScale;
 
 			// A dirty fix to avoid polygon slivers narrower than 1 pixel, as the polygon filling routines currently do not
 			// correctly plot such slivers. The aperture height is limited to minimum value so that after scaling,
@@ -517,7 +942,26 @@ void Gerber::processDataBlock()
 
 			if (drawingMode == LINEAR_1X)
 			{
-				if (toolShift > 1)			// don't bother drawing traces of tiny length
+				if (isRoundTrace)
+				{
+					double radius = max(polygon_heigth, polygon_width) / 2;
+					double angle = atan2(dY, dX);
+					polygons.push_back(Polygon());
+					vertexdata.push_back( polygons.back().vdata ); 	// Save pointer to vertex data for the newly created Polygon
+					if (layerPolarityClear) { polygons.back().polarity = CLEAR; }	// polygon polarity dependent on PLC / PLD parameters
+					polygons.back().vdata->addArcEdge(angle + M_PI/2, angle + 1.5*M_PI, radius, oldX, oldY);
+					polygons.back().vdata->addArcEdge(angle - M_PI/2, angle + M_PI/2, radius, X, Y);
+					polygons.back().vdata->scale(scaleFactor[0], -scaleFactor[1]);
+				}
+				else if (isRectangleTrace)
+				{
+					polygons.push_back(Polygon());
+					vertexdata.push_back( polygons.back().vdata ); 	// Save pointer to vertex data for the newly created Polygon
+					if (layerPolarityClear) { polygons.back().polarity = CLEAR; }	// polygon polarity dependent on PLC / PLD parameters
+					polygons.back().vdata->addRectangle(fabs(dX) + polygon_width, fabs(dY) + polygon_heigth, (oldX + X) / 2, (oldY + Y) / 2);
+					polygons.back().vdata->scale(scaleFactor[0], -scaleFactor[1]);
+				}
+				else if (toolShift > 1 && isGeometryEnabled && !apertureSelect->isDropped)	// don't bother drawing traces of tiny length
 				{
 					double sy, sx;
 					// width of line or arc draw by using height of the polygon for this aperture.
@@ -551,7 +995,7 @@ void Gerber::processDataBlock()
 					polygons.back().vdata->scale(scaleFactor[0], -scaleFactor[1]);
 
 				}
-				if (toolShift > 0)		// don't flash when line length is exactly zero because the initial flash is acceptable.
+				if (toolShift > 0 && !isWholeTrace)		// don't flash when line length is exactly zero because the initial flash is acceptable.
 				{
 					flashAperture(X, Y);		// flashes aperture at very end of line.
 				}
@@ -563,12 +1007,17 @@ void Gerber::processDataBlock()
 				calculateArc( arc );
 				if (! arc.isTooSmall )
 				{
-					polygons.push_back(Polygon());
-					vertexdata.push_back( polygons.back().vdata ); 	// Save pointer to vertex data for the newly created Polygon
-					polygons.back().vdata->addArc(arc.start, arc.end, arc.radius - (polygon_heigth)/2, arc.centre.x, arc.centre.y, (drawingMode == CIRCLE_CLOCKWISE));
-					polygons.back().vdata->addArc(arc.end, arc.start, arc.radius + (polygon_heigth)/2, arc.centre.x, arc.centre.y, (drawingMode != CIRCLE_CLOCKWISE));
-					polygons.back().vdata->scale(scaleFactor[0], -scaleFactor[1]);
-					if (layerPolarityClear) { polygons.back().polarity = CLEAR; }	// polygon polarity dependent on PLC / PLD parameters
+					if (isGeometryEnabled && !apertureSelect->isDropped)
+					{
+						polygons.push_back(Polygon());
+						vertexdata.push_back( polygons.back().vdata ); 	// Save pointer to vertex data for the newly created Polygon
+						polygons.back().vdata->addArcEdge(arc.start, arc.end, arc.radius - (polygon_heigth)/2, arc.centre.x, arc.centre.y, (drawingMode == CIRCLE_CLOCKWISE));
+						polygons.back().vdata->addArcEdge(arc.end, arc.start, arc.radius + (polygon_heigth)/2, arc.centre.x, arc.centre.y, (drawingMode != CIRCLE_CLOCKWISE));
+						polygons.back().vdata->scale(scaleFactor[0], -scaleFactor[1]);
+						if (layerPolarityClear) { polygons.back().polarity = CLEAR; }	// polygon polarity dependent on PLC / PLD parameters
+					}
+					else if (mode == PARSE_LINT && !apertureSelect->isDropped)
+						addArcExtents(arc, polygon_heigth/2, (drawingMode == CIRCLE_CLOCKWISE));
 					oldX = arc.stopped.x;				// set oldX,oldY to stopped point of arc
 					oldY = arc.stopped.y;
 				}
@@ -601,6 +1050,309 @@ void Gerber::processDataBlock()
 
 
 
+//--------------------------------------------------------------------------------------------------
+// Fast path for data blocks held in memory.
+// Decodes a data block made only of X, Y, I, J, D and G words, e.g. "X1500Y-200D01*", and
+// applies it exactly as the lexer and grammar actions would, without going through flex and bison.
+// The whole block is checked before any command is applied, so when false is returned nothing
+// has changed and the block must be parsed by the grammar. On success *next points after the '*'.
+//--------------------------------------------------------------------------------------------------
+bool Gerber::processFastDataBlock(const char * text, const char * end, const char ** next)
+{
+	const int MAX_WORDS = 8;
+	const int MAX_DIGITS = 24;
+	struct
+	{
+		char letter;
+		char digits[MAX_DIGITS + 2];		// optional sign, digits and terminating zero
+		int newlines;						// line feeds found before this word
+	} words[MAX_WORDS];
+	int count = 0;
+	int newlines = 0;
+	const char * p = text;
+
+	while (1)
+	{
+		if (p == end)	return false;		// incomplete block at end of file
+		char c = *p;
+		if (c == '*')	break;
+		if (c == ' ' || c == '\t' || c == '\r')	{ p++; continue; }
+		if (c == '\n')	{ newlines++; p++; continue; }
+
+		bool isCoordinate = (c == 'X' || c == 'Y' || c == 'I' || c == 'J');
+		if ((!isCoordinate && c != 'D' && c != 'G') || count == MAX_WORDS)
+			return false;
+		words[count].letter = c;
+		words[count].newlines = newlines;
+		newlines = 0;
+		p++;
+
+		int n = 0;
+		if (isCoordinate && p < end && (*p == '-' || *p == '+'))
+			words[count].digits[n++] = *p++;
+		const char * digits = p;
+		while (p < end && *p >= '0' && *p <= '9' && n < MAX_DIGITS)
+			words[count].digits[n++] = *p++;
+		words[count].digits[n] = 0;
+
+		// no digits, too many digits or a decimal number
+		if (p == digits || p == end || *p == '.' || (*p >= '0' && *p <= '9'))
+			return false;
+
+		// G04 comments are recognised by the lexer as G0*4...
+		if (c == 'G')
+		{
+			while (*digits == '0') digits++;
+			if (*digits == '4')	return false;
+		}
+		count++;
+	}
+
+	// Apply the commands in the order they appear in the block
+	for (int i=0; i < count; i++)
+	{
+		currentLine += words[i].newlines;
+		char * digits = words[i].digits;
+		switch (words[i].letter)
+		{
+		case 'X':	X = getCoordinate(digits, 0); break;
+		case 'Y':	Y = getCoordinate(digits, 1); break;
+		case 'I':	I = getCoordinate(digits, 0, true); break;
+		case 'J':	J = getCoordinate(digits, 1, true); break;
+		case 'D':	process_D_command(int(atof(digits))); break;
+		case 'G':	process_G_command(int(atof(digits))); break;
+		}
+	}
+	currentLine += newlines;
+	if (count > 0)				// an empty block "*" is not processed by the grammar either
+		processDataBlock();
+	*next = p + 1;
+	return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Parse data blocks held in memory, starting at /text, until at least /minLength characters
+// have been read and the parser is not inside a G36/G37 region, or until /end.
+// Plain coordinate data blocks are handled by processFastDataBlock(). Parameter blocks and
+// any other data block are handed to the grammar one block at a time.
+// Returns the position following the last block parsed.
+//--------------------------------------------------------------------------------------------------
+const char * Gerber::scanBlocks(const char * text, const char * end, size_t minLength, void * scanner)
+{
+	const char * p = text;
+	string blocks;
+
+	while (p < end && !isProgramStopped)
+	{
+		// chunks start outside of regions, step and repeat blocks and block apertures
+		if (size_t(p - text) >= minLength && !isPolygonFill && repeat.X == 1 && repeat.Y == 1 && openBlocks.empty())
+			break;
+
+		char c = *p;
+		if (c == ' ' || c == '\t' || c == '\r')	{ p++; continue; }
+		if (c == '\n')	{ currentLine++; p++; continue; }
+
+		if (processFastDataBlock(p, end, &p))
+		{
+			isFirstBlock = false;
+			continue;
+		}
+
+		// find the end of the block(s) to be parsed by the grammar
+		const char * q = p + 1;
+		if (c == '%')
+		{
+			// parameter blocks end with a '%' found at the start of a block
+			while (q < end)
+			{
+				while (q < end && (*q == ' ' || *q == '\t' || *q == '\r' || *q == '\n')) q++;
+				if (q < end && *q == '%') { q++; break; }
+				while (q < end && *q != '*') q++;
+				if (q < end) q++;
+			}
+		}
+		else
+		{
+			// G04 comments may contain a '%'. Otherwise a '%' within a data block is unusual,
+			// so the rest of the input is left to the grammar.
+			const char * d = p + 1;
+			while (d < end && *d == '0') d++;
+			bool isComment = (c == 'G' && d < end && *d == '4');
+			while (q < end && *q != '*')
+			{
+				if (*q == '%' && !isComment) { q = end; break; }
+				q++;
+			}
+			if (q < end) q++;
+		}
+
+		// Unless this is the start of the file, an empty block is put in front so the grammar
+		// continues from a complete data block, e.g. stopping at M03 is then not an error.
+		blocks.assign(isFirstBlock ? "" : "*");
+		blocks.append(p, q - p);
+		yy_scan_bytes(blocks.data(), blocks.size(), scanner);
+		yyparse(this, scanner);
+		isFirstBlock = false;
+		p = q;
+	}
+	return p;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Parse a Gerber file held in memory.
+//--------------------------------------------------------------------------------------------------
+void Gerber::scanBuffer(const char * text, size_t length, void * scanner)
+{
+	scanBlocks(text, text + length, length, scanner);
+
+	// let the grammar report an empty file
+	if (isFirstBlock)
+	{
+		yy_scan_bytes("", 0, scanner);
+		yyparse(this, scanner);
+	}
+}
+
+
+// Files held in memory are parsed in parallel chunks of at least this many characters.
+static const size_t MIN_CHUNK_SIZE = 1<<20;
+
+// A part of a memory mapped file, parsed by its own Gerber object holding the modal state at the chunk start.
+struct GerberChunk
+{
+	const char * text;
+	size_t length;
+	Gerber * gerber;
+	string error;
+};
+
+struct GerberChunkQueue
+{
+	vector<GerberChunk> chunks;
+	unsigned next;					// index of the next chunk to be taken by a worker
+	pthread_mutex_t lock;
+	double imageRotate;				// IR parameter of the whole file
+};
+
+
+void * Gerber::chunkWorker(void * arg)
+{
+	GerberChunkQueue * queue = (GerberChunkQueue *)arg;
+	while (1)
+	{
+		pthread_mutex_lock(&queue->lock);
+		unsigned i = queue->next++;
+		pthread_mutex_unlock(&queue->lock);
+		if (i >= queue->chunks.size())
+			break;
+
+		GerberChunk &chunk = queue->chunks[i];
+		Gerber * g = chunk.gerber;
+		void * scanner = 0;
+		try
+		{
+			if (yylex_init(&scanner))
+				throw string("cannot create scanner");
+			g->scanBlocks(chunk.text, chunk.text + chunk.length, chunk.length, scanner);
+			g->stepRepeat(1, 1, 0, 0);		// close a step and repeat block left open at the end of file
+			g->imageRotate = queue->imageRotate;
+			g->initialiseGeometry();
+		}
+		catch (const string& msg)
+		{
+			g->isError = true;
+			chunk.error = msg;
+		}
+		if (scanner)
+			yylex_destroy(scanner);
+	}
+	return 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Parse a large file held in memory using several threads.
+// Gerber data is modal, so the file is first pre-scanned sequentially with geometry construction
+// disabled. This finds the block boundaries and keeps track of the modal state (units, format,
+// drawing mode, polarity, apertures, current position...) at low cost. Every chunkSize characters
+// a copy of the modal state is taken at a block boundary outside of any G36/G37 region.
+// The chunks then build their polygons in parallel, starting from these copies, and the polygons
+// are appended in file order so the drawing order is the same as a sequential parse.
+// Messages and parameters of the whole file come from the pre-scan.
+//--------------------------------------------------------------------------------------------------
+void Gerber::parseChunks(const char * text, size_t length, void * scanner, int threads)
+{
+	GerberChunkQueue queue;
+	size_t chunkSize = max(MIN_CHUNK_SIZE, length / (4 * threads));
+	const char * p = text;
+	const char * end = text + length;
+
+	try
+	{
+		isGeometryEnabled = false;
+		while (p < end && !isProgramStopped)
+		{
+			GerberChunk chunk;
+			chunk.text = p;
+			chunk.gerber = new Gerber(this);
+			queue.chunks.push_back(chunk);
+			p = scanBlocks(p, end, chunkSize, scanner);
+			queue.chunks.back().length = p - chunk.text;
+		}
+		isGeometryEnabled = true;
+		if (isFirstBlock)
+			scanBuffer(text, 0, scanner);	// report an empty file
+	}
+	catch (...)
+	{
+		for (unsigned i=0; i < queue.chunks.size(); i++)
+			delete queue.chunks[i].gerber;
+		throw;
+	}
+
+	// the aperture vertices made by the pre-scan are shared by the chunks and must be ready first
+	initialiseGeometry();
+
+	queue.next = 0;
+	queue.imageRotate = imageRotate;
+	pthread_mutex_init(&queue.lock, 0);
+	if (threads > (int)queue.chunks.size())
+		threads = queue.chunks.size();
+	vector<pthread_t> workers;
+	for (int i=1; i < threads; i++)
+	{
+		pthread_t tid;
+		if (pthread_create(&tid, 0, chunkWorker, &queue) == 0)
+			workers.push_back(tid);
+	}
+	chunkWorker(&queue);
+	for (unsigned i=0; i < workers.size(); i++)
+		pthread_join(workers[i], 0);
+	pthread_mutex_destroy(&queue.lock);
+
+	// append the chunks in file order
+	string error;
+	for (unsigned i=0; i < queue.chunks.size(); i++)
+	{
+		Gerber * g = queue.chunks[i].gerber;
+		if (g->isError && error.empty())
+		{
+			error = queue.chunks[i].error;
+			currentLine = g->currentLine;
+		}
+		apertureLookups += g->apertureLookups;
+		polygons.splice(polygons.end(), g->polygons);
+		vertexdata.splice(vertexdata.end(), g->vertexdata);
+		delete g;
+	}
+	if (!error.empty())
+		throw error;
+}
+
+
+
 /*
  * Initialize all Gerber parameters to default values;
  * this function is called in Gerber constructor and M02 (End of program) commands encounted.
@@ -613,16 +1365,19 @@ void Gerber::processDataBlock()
 void Gerber::loadDefaults()
 {
 	isDrawingEnabled = false;
-	lastDrawnApertureSelect = ad_apertures.begin();
+	lastDrawnApertureSelect = 0;
 	isWarnNoApertureSelect = false;
 	layerPolarityClear = false;
+	isLoadMirrorX = isLoadMirrorY = false;
+	loadRotation = 0;
+	loadScale = 1;
 	scaleFactor[0] = optScaleX;
 	scaleFactor[1] = optScaleY;
 	imageOffsetPixels[0]=imageOffsetPixels[1]=0;
-	repeat.X = 1;
-	repeat.Y = 1;
-	repeat.I = 0;
-	repeat.J = 0;
+	stepRepeat(1, 1, 0, 0);
+	if (!openBlocks.empty())
+		isGeometryEnabled = openBlocks.front().isGeometryEnabled;
+	openBlocks.clear();
 	isLampOn = false;
 	isMirrorAaxis = false;
 	isMirrorBaxis = false;
@@ -630,6 +1385,7 @@ void Gerber::loadDefaults()
 	drawingMode = LINEAR_1X;
 	isCircular360 = false;					// safest to assume single quadrant mode.
 	isPolygonFill = false;
+	isRegionDropped = false;
 	// must initialize plotter coordinates to zero, (also undocumented in RS-274X)
 	// Some gerber files can start drawing without setting both or either X and Y coordinates !
 	oldX = oldY = X = Y = 0;
@@ -638,12 +1394,17 @@ void Gerber::loadDefaults()
 	// The macro modifiers will be of variable type, listed from $1 to $5. Note, the P aperture can have up to 5 modifiers.
 	macro_apertures.clear();
 	ad_apertures.clear();
-	Aperture arp;
-	arp.parameter.resize(5);
+	apertureTable.clear();
+	apertureTableLarge.clear();
+	MacroProgram * program = new MacroProgram;
 	for (int i=0; i < 5; i++)
 	{
-		arp.parameter[i] = new NodeT(NodeT::VAR, &i, &variables);
+		NodeT var(NodeT::VAR, &i, &variables);
+		program->compile(&var);
 	}
+	Aperture arp;
+	arp.program = program;
+	arp.parameterCount = program->parameterCount;
 	arp.nameMacro = "C";
 	arp.primitive = Aperture::STANDARD_CIRCLE;
 	macro_apertures.push_back(arp);
@@ -668,7 +1429,7 @@ void Gerber::loadDefaults()
 	units = INCH;	// Temporarily set inches just to construct this aperture
 	variables.push_back ( 1.5/dotsPerUnit() );
 	process_AD_block(-1);
-	apertureSelect = ad_apertures.begin();		// select to default aperture
+	apertureSelect = &ad_apertures.front();		// select to default aperture
 	units = ut;									// restore previous units
 
 }
@@ -684,6 +1445,10 @@ void Gerber::loadDefaults()
 // entry -
 //
 // fp_gerb must point to file name of the Gerber file.
+// or
+// text, length hold the complete Gerber file in memory (e.g. a memory mapped file).
+// Plain coordinate data blocks are then decoded by a fast scanner and only the
+// remaining blocks are parsed by the grammar.
 //
 // return -
 //
@@ -694,65 +1459,371 @@ void Gerber::loadDefaults()
 // contain useful information.
 //
 // *****************************************************************************
-Gerber::Gerber(FILE * fp_gerb, const double dotsPerInch, const double growSize, double optScaleX, double optScaleY)
+Gerber::Gerber(FILE * fp_gerb, const double dotsPerInch, const double growSize, double optScaleX, double optScaleY, ParseMode mode, const FunctionFilter * filter)
 	: dotsPerInch(dotsPerInch), growSize(growSize)
 	 ,optScaleX(optScaleX), optScaleY(optScaleY)
+	 ,mode(mode), filter(filter)
 {
+	parse(fp_gerb, 0, 0, 1);
+}
+
+Gerber::Gerber(const char * text, size_t length, const double dotsPerInch, const double growSize, double optScaleX, double optScaleY, int threads, ParseMode mode, const FunctionFilter * filter)
+	: dotsPerInch(dotsPerInch), growSize(growSize)
+	 ,optScaleX(optScaleX), optScaleY(optScaleY)
+	 ,mode(mode), filter(filter)
+{
+	parse(0, text, length, threads);
+}
+
+// Set the options only, for loading a display list or an incremental parse.
+Gerber::Gerber(const double dotsPerInch, const double growSize, double optScaleX, double optScaleY, ParseMode mode, const FunctionFilter * filter)
+	: dotsPerInch(dotsPerInch), growSize(growSize)
+	 ,optScaleX(optScaleX), optScaleY(optScaleY)
+	 ,mode(mode), filter(filter)
+{
+	imageRotate = 0;
+	imagePolarityDark = true;
+	isError = false;
+	warningCount = 0;
+	apertureLookups = 0;
+	currentLine = 0;
+	streamScanner = 0;
+}
+
+// Copy the modal state of another parser, so that a chunk of a file can be parsed from its
+// middle. The polygons, vertices and messages are not copied.
+Gerber::Gerber(const Gerber * state)
+	: dotsPerInch(state->dotsPerInch), growSize(state->growSize)
+	 ,optScaleX(state->optScaleX), optScaleY(state->optScaleY)
+	 ,mode(state->mode), filter(state->filter)
+{
+	streamScanner = 0;
+	for (int i=0; i < 2; i++)
+	{
+		coordPrevious[i] = state->coordPrevious[i];
+		scaleFactor[i] = state->scaleFactor[i];
+		imageOffsetPixels[i] = state->imageOffsetPixels[i];
+		coordsDecimals[i] = state->coordsDecimals[i];
+		coordsInts[i] = state->coordsInts[i];
+	}
+	layerPolarityClear = state->layerPolarityClear;
+	isLoadMirrorX = state->isLoadMirrorX;
+	isLoadMirrorY = state->isLoadMirrorY;
+	loadRotation = state->loadRotation;
+	loadScale = state->loadScale;
+	isAxisSwapped = state->isAxisSwapped;
+	isOmitLeadingZeroes = state->isOmitLeadingZeroes;
+	isCoordsAbsolute = state->isCoordsAbsolute;
+	units = state->units;
+	coordFormat = state->coordFormat;
+	isMirrorAaxis = state->isMirrorAaxis;
+	isMirrorBaxis = state->isMirrorBaxis;
+	currentLine = state->currentLine;
+	isProgramStopped = state->isProgramStopped;
+	isFirstBlock = state->isFirstBlock;
+	isGeometryEnabled = true;
+	drawingMode = state->drawingMode;
+	isCircular360 = state->isCircular360;
+	isPolygonFill = state->isPolygonFill;
+	isRegionDropped = state->isRegionDropped;
+	apertureAttributes = state->apertureAttributes;
+	isLampOn = state->isLampOn;
+	lastDrawnX = state->lastDrawnX;
+	lastDrawnY = state->lastDrawnY;
+	imageRotate = state->imageRotate;
+	isDrawingEnabled = state->isDrawingEnabled;
+	warningCount = state->warningCount;
+	isWarnNoApertureSelect = state->isWarnNoApertureSelect;
+	temporaryNameMacro = state->temporaryNameMacro;
+	variables = state->variables;
+	X = state->X;
+	Y = state->Y;
+	oldX = state->oldX;
+	oldY = state->oldY;
+	I = state->I;
+	J = state->J;
+	repeat = state->repeat;
+	repeat.firstPolygon = 0;
+	openBlocks = state->openBlocks;
+	for (unsigned i=0; i < openBlocks.size(); i++)
+		openBlocks[i].firstPolygon = 0;
+	imagePolarityDark = state->imagePolarityDark;
+	layerName = state->layerName;
+	imageName = state->imageName;
+	imageFilm = state->imageFilm;
+	isError = false;
+
+	// compiled macro programs are not changed after compiling and are shared
+	macro_apertures = state->macro_apertures;
+
+	// composite links, aperture selections and the D-code table point into the list, map them to the copies
+	map<const Aperture *, Aperture *> copies;
+	copies[0] = 0;
+	for (list<Aperture>::const_iterator it = state->ad_apertures.begin(); it != state->ad_apertures.end(); it++)
+	{
+		ad_apertures.push_back(*it);
+		copies[&*it] = &ad_apertures.back();
+	}
+	for (list<Aperture>::iterator it = ad_apertures.begin(); it != ad_apertures.end(); it++)
+		it->composite = copies[it->composite];
+	apertureSelect = copies[state->apertureSelect];
+	lastDrawnApertureSelect = copies[state->lastDrawnApertureSelect];
+	apertureTable.resize(state->apertureTable.size());
+	for (unsigned i=0; i < apertureTable.size(); i++)
+		apertureTable[i] = copies[state->apertureTable[i]];
+	for (map<int, Aperture *>::const_iterator it = state->apertureTableLarge.begin(); it != state->apertureTableLarge.end(); it++)
+		apertureTableLarge[it->first] = copies[it->second];
+	apertureLookups = 0;
+}
+
+
+// Rotate as specified by the IR parameter and initialise the extents of all vertices, then the polygons
+// using them. The scan line data is made by the renderer, when the first polygon using it is drawn.
+// Aperture vertices from the ApertureCache are initialised already, they are only copied when rotated.
+void Gerber::initialiseGeometry()
+{
+	for (list<VertexData *>::iterator it = vertexdata.begin(); it != vertexdata.end(); it++)
+	{
+		(*it)->rotate(imageRotate);
+		(*it)->initialiseExtents();
+	}
+	map<VertexData *, VertexData *> rotated;
+	for (list<Polygon>::iterator it = polygons.begin(); it != polygons.end(); it++)
+	{
+		if (it->empty())
+			continue;
+		if (it->vdata->isShared && imageRotate != 0)
+		{
+			VertexData * &copy = rotated[it->vdata];
+			if (copy == 0)
+			{
+				copy = new VertexData;
+				copy->vertices = it->vdata->vertices;
+				copy->arcs = it->vdata->arcs;
+				copy->rotate(imageRotate);
+				copy->initialiseExtents();
+			}
+			it->vdata = copy;
+		}
+		it->offset.rotate(imageRotate);
+		it->initialise();		// Initialise to calculate the pixel limits
+	}
+}
+
+void Gerber::parse(FILE * fp_gerb, const char * text, size_t length, int threads)
+{
+	void *scanner = 0;
+	bool isChunked = !fp_gerb && mode != PARSE_LINT && threads > 1 && length >= 2*MIN_CHUNK_SIZE;
     try
     {
-    	imageRotate = 0;
-    	imagePolarityDark = true;
-    	isError = false;
-    	warningCount = 0;
-		currentLine = 1;
-		coordsInts[0] = -1;					// assign to negative value until FS parameter encounter
-		units = UNDEFINED;
-
-		loadDefaults();
-		yyrestart(fp_gerb);					// set a new input file for FLEX, flushes input buffer.
-    	yyparse(this);
-
-    	// Modify then Initialise all vertices used by the polygons
-        for (list<VertexData *>::iterator it = vertexdata.begin(); it != vertexdata.end(); it++)
-        {
-        	(*it)->rotate(imageRotate);	// Rotate the vertices specified by the Image Rotate parameter.
-        	(*it)->initialise();
-        }
-
-    	// Initialise the polygons
-    	int k = 0;
-        for (list<Polygon>::iterator it = polygons.begin(); it != polygons.end(); )
-        {
-        	if (it->empty())
-        	{
-        		it = polygons.erase(it);
-        		continue;
-        	}
-
-        	// Rotate entire gerber image as specified by IR parameter
-        	it->offset.rotate(imageRotate);
-
-        	it->initialise();		// Initialise to calculate  raster x1,x2 data.
-
-        	// Identify each polygon with a drawing order number.
-        	// This member is used to plot polygons in the order specified in gerber file.
-        	it->number = k;
-        	k++;
-        	it++;
-        }
-
-        if (polygons.size() == 0)
-			warning("nothing to draw");
-
-        // Sort all polygons object so they have ascending miny values.
-     	polygons.sort();
-
+		startParse();
+		if (yylex_init(&scanner))
+			throw string("cannot create scanner");
+		if (fp_gerb)
+		{
+			yyrestart(fp_gerb, scanner);	// set a new input file for FLEX, flushes input buffer.
+    		yyparse(this, scanner);
+		}
+		else if (isChunked)
+			parseChunks(text, length, scanner, threads);	// initialises the geometry as well
+		else
+			scanBuffer(text, length, scanner);
+		finishParse(isChunked);
     }
 	catch (const string& msg)
 	{
-    	isError = true;
-    	errorMessage << "error: " << msg << ". stopped at line " << currentLine;
+		parseError(msg);
+	}
+	if (scanner)
+		yylex_destroy(scanner);
+}
+
+// Initialise the parser state before the first block of a file
+void Gerber::startParse()
+{
+	imageRotate = 0;
+	imagePolarityDark = true;
+	isError = false;
+	warningCount = 0;
+	apertureLookups = 0;
+	currentLine = 1;
+	isProgramStopped = false;
+	isFirstBlock = true;
+	isGeometryEnabled = (mode != PARSE_LINT);
+	repeat.X = repeat.Y = 1;
+	repeat.firstPolygon = 0;
+	openBlocks.clear();
+	coordsInts[0] = -1;					// assign to negative value until FS parameter encounter
+	units = UNDEFINED;
+	coordFormat.units = UNDEFINED;
+	coordFormat.ints[0] = coordFormat.ints[1] = -1;		// not calculated yet
+	streamScanner = 0;
+
+	loadDefaults();
+}
+
+// Make the geometry ready for drawing after the last block of a file.
+// The geometry of a file parsed in chunks has already been initialised by the chunks.
+void Gerber::finishParse(bool isGeometryInitialised)
+{
+	// Modify then Initialise all vertices used by the polygons
+	if (!isGeometryInitialised)
+	{
+		stepRepeat(1, 1, 0, 0);		// close a step and repeat block left open at the end of file
+		if (mode != PARSE_LINT)
+			initialiseGeometry();
+	}
+	if (mode == PARSE_LINT && imageRotate != 0 && !extents.empty())
+	{
+		Extents box = extents;
+		extents = Extents();
+		for (int i=0; i < 4; i++)
+		{
+			Point P = box.corner(i);
+			P.rotate(imageRotate);
+			extents.add(P);
+		}
+	}
+
+	// Number the polygons
+	int k = 0;
+	for (list<Polygon>::iterator it = polygons.begin(); it != polygons.end(); )
+	{
+		if (it->empty())
+		{
+			it = polygons.erase(it);
+			continue;
+		}
+
+		// Identify each polygon with a drawing order number.
+		// This member is used to plot polygons in the order specified in gerber file.
+		it->number = k;
+		k++;
+		it++;
+	}
+
+	if ((mode == PARSE_LINT) ? extents.empty() : polygons.size() == 0)
+		warning("nothing to draw");
+
+	// Sort all polygons object so they have ascending miny values.
+	polygons.sort();
+}
+
+void Gerber::parseError(const string &msg)
+{
+	isError = true;
+	errorMessage << "error: " << msg << ". stopped at line " << currentLine;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Incremental parsing of a file received in pieces, e.g. from a socket or a pipe.
+// The blocks completed by each piece are parsed right away, using the same block scanner as a
+// file held in memory, so parsing overlaps with the transfer. Only the incomplete block at the
+// end of the data received so far is kept until the next piece arrives.
+//--------------------------------------------------------------------------------------------------
+Gerber * Gerber::beginParse(double dotsPerInch, double growSize, double optScaleX, double optScaleY, ParseMode mode, const FunctionFilter * filter)
+{
+	Gerber * g = new Gerber(dotsPerInch, growSize, optScaleX, optScaleY, mode, filter);
+	try
+	{
+		g->startParse();
+		if (yylex_init(&g->streamScanner))
+			throw string("cannot create scanner");
+	}
+	catch (const string& msg)
+	{
+		g->parseError(msg);
+	}
+	return g;
+}
+
+// Returns false when no more data is needed: the program has stopped or an error occurred.
+bool Gerber::parsePart(const char * data, size_t length)
+{
+	if (isError || isProgramStopped)
+		return false;
+	try
+	{
+		streamPending.append(data, length);
+		const char * text = streamPending.data();
+		const char * end = findCompleteBlocks(text, text + streamPending.size());
+		if (end > text)
+		{
+			const char * p = scanBlocks(text, end, end - text, streamScanner);
+			streamPending.erase(0, p - text);
+		}
+	}
+	catch (const string& msg)
+	{
+		parseError(msg);
+	}
+	return !isError && !isProgramStopped;
+}
+
+void Gerber::endParse()
+{
+	try
+	{
+		if (!isError)
+		{
+			scanBuffer(streamPending.data(), streamPending.size(), streamScanner);	// reports an incomplete last block
+			finishParse(false);
+		}
+	}
+	catch (const string& msg)
+	{
+		parseError(msg);
+	}
+	streamPending.clear();
+	if (streamScanner)
+		yylex_destroy(streamScanner);
+	streamScanner = 0;
+}
+
+// Returns the end of the last complete block in /text, following the rules of scanBlocks().
+// A data block holding a '%' that is not a G04 comment is left for the end of the file.
+const char * Gerber::findCompleteBlocks(const char * text, const char * end)
+{
+	const char * p = text;
+	const char * complete = text;
+	while (p < end)
+	{
+		char c = *p;
+		if (c == ' ' || c == '\t' || c == '\r' || c == '\n')	{ p++; continue; }
+
+		const char * q = p + 1;
+		if (c == '%')
+		{
+			bool isClosed = false;
+			while (q < end)
+			{
+				while (q < end && (*q == ' ' || *q == '\t' || *q == '\r' || *q == '\n')) q++;
+				if (q < end && *q == '%') { q++; isClosed = true; break; }
+				while (q < end && *q != '*') q++;
+				if (q < end) q++;
+			}
+			if (!isClosed)
+				break;
+		}
+		else
+		{
+			const char * d = p + 1;
+			while (d < end && *d == '0') d++;
+			bool isComment = (c == 'G' && d < end && *d == '4');
+			while (q < end && *q != '*')
+			{
+				if (*q == '%' && !isComment)
+					return complete;
+				q++;
+			}
+			if (q == end)
+				break;
+			q++;
+		}
+		p = complete = q;
 	}
+	return complete;
 }
 
 
@@ -27,6 +27,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include <complex>
 #include <vector>
 #include <list>
+#include <map>
+#include <set>
 #include <math.h>
 #include <ctype.h>
 #ifdef __linux__
@@ -64,15 +66,39 @@ typedef struct T_Arc
 } Arc;
 
 
-extern char *yytext;
-extern void yyrestart( FILE *new_file );
+// Reentrant FLEX scanner interface. Each Gerber object owns its own scanner
+// so that several files may be parsed concurrently.
+union YYSTYPE;
+extern int yylex_init( void **scanner );
+extern int yylex_destroy( void *scanner );
+extern void yyrestart( FILE *new_file, void *scanner );
+extern char *yyget_text( void *scanner );
+extern struct yy_buffer_state *yy_scan_bytes( const char *bytes, size_t len, void *scanner );
 
 
+// What the parser makes of a file.
+enum ParseMode
+{
+	PARSE_RENDER,		// polygons ready to be drawn, their scan line data is made while rendering
+	PARSE_PLAN,			// the same polygons, to estimate the rendering
+	PARSE_LINT			// only the messages and the extents, no polygons
+};
+
+// Selection of the objects drawn by their X2 .AperFunction attribute, the first field of its
+// value, e.g. "SMDPad" or "Conductor". Objects without the attribute have the function "".
+// When functions are included only those are drawn. Excluded functions are never drawn.
+struct FunctionFilter
+{
+	std::set<std::string> include;
+	std::set<std::string> exclude;
+	bool isDrawn(const std::map<std::string, std::string> &attributes) const;
+};
+
 class Gerber {
 
 
-	friend  int yylex(Gerber *gerb);
-	friend  int yyparse(Gerber *gerb);
+	friend  int yylex(union YYSTYPE *yylval, Gerber *gerb, void *scanner);
+	friend  int yyparse(Gerber *gerb, void *scanner);
 	private:
 		enum APETURE_DRAWING_MODE {CIRCLE_CLOCKWISE, CIRCLE_ANTICLOCKWISE, LINEAR_10X, LINEAR_1X, LINEAR_01X, LINEAR_001X, CIRCULAR360, _INVALID_};
 		typedef enum {MILLIMETER, INCH, UNDEFINED} Units_t ;
@@ -86,20 +112,63 @@ class Gerber {
 		double scaleFactor[2];
 		double imageOffsetPixels[2];		// offset of the image in pixels specified by %IO parameter
 		bool layerPolarityClear;
+		// Load transformation of %LM, %LR and %LS, applied to the apertures flashed
+		bool isLoadMirrorX;
+		bool isLoadMirrorY;
+		double loadRotation;			// radians anticlockwise
+		double loadScale;
+		bool isLoadTransformed()	{ return isLoadMirrorX || isLoadMirrorY || loadRotation != 0 || loadScale != 1; }
+		Point loadTransform(Point P);
+		// Aperture vertices with a load transformation applied, made once per aperture and transformation.
+		struct TransformKey
+		{
+			const VertexData * vdata;
+			bool isMirrorX;
+			bool isMirrorY;
+			double rotation;
+			double scale;
+			bool operator<(const TransformKey &rhs) const;
+		};
+		std::map< TransformKey, VertexData * > transformedVertices;
+		VertexData * transformVertices(VertexData * source);
 		int coordsDecimals[2];
 		int coordsInts[2];
 		bool isAxisSwapped;
 		bool isOmitLeadingZeroes;
         bool isCoordsAbsolute;
         Units_t units;
+
+		// Coordinate format used by getCoordinate(), updated when %FS or %MO have changed.
+		static const int MAX_COORD_DIGITS = 18;		// digits decoded exactly in 64 bit
+		struct CoordinateFormat
+		{
+			int ints[2];
+			int decimals[2];
+			bool isOmitLeadingZeroes;
+			Units_t units;
+			double dotsPerUnit;
+			double divisor[2][MAX_COORD_DIGITS + 1];	// per axis and number of digits, Gerber units per unit
+		} coordFormat;
+		void updateCoordinateFormat();
 		bool isMirrorAaxis;				// negative all A axis coordinate data
 		bool isMirrorBaxis;				// negative all B axis coordinate data
 		int currentLine;
+		bool isProgramStopped;			// set by M03, no more data is read
+		bool isFirstBlock;				// no data block has been parsed yet
+		bool isGeometryEnabled;			// false while pre-scanning a file for chunk boundaries, and in lint mode
+		ParseMode mode;
+		void addFlashExtents(double x, double y);
+		void addArcExtents(const Arc &arc, double halfWidth, bool isClockwise);
+		void addExtents(double x, double y);
+		const FunctionFilter * filter;	// X2 aperture functions drawn, 0 to draw all objects
+		std::map< std::string, std::string > apertureAttributes;	// X2 aperture attribute dictionary, set by %TA and %TD
+		bool isRegionDropped;			// the current G36 region is not drawn, its function is filtered out
+		void processAttribute(const char * text);
 		enum APETURE_DRAWING_MODE 	drawingMode;
 		bool isCircular360;
 		bool isPolygonFill;
 		bool isLampOn;
-		std::list<Aperture>::iterator lastDrawnApertureSelect;
+		Aperture * lastDrawnApertureSelect;
 		double lastDrawnX;
 		double lastDrawnY;
 		double imageRotate;
@@ -108,7 +177,7 @@ class Gerber {
 		int warningCount;
 		bool isWarnNoApertureSelect;
 
-		std::list<Aperture>::iterator apertureSelect;
+		Aperture * apertureSelect;
 
 		std::vector< NodeT * > 	temporaryParameters;
 		string 					temporaryNameMacro;
@@ -126,22 +195,56 @@ class Gerber {
 		double getCoordinate( char * const text, int axisNumber, bool alwaysAbsolute = false);
 		void calculateArc(Arc &arc);
 		void process_AD_block(int DCode);
+		void compileMacro();
 		void process_D_command(int code);
 		void process_G_command(int code);
 		void processDataBlock();
+		bool processFastDataBlock(const char * text, const char * end, const char ** next);
+		const char * scanBlocks(const char * text, const char * end, size_t minLength, void * scanner);
+		void scanBuffer(const char * text, size_t length, void * scanner);
+		void parseChunks(const char * text, size_t length, void * scanner, int threads);
+		static void * chunkWorker(void * queue);
+		void initialiseGeometry();
+		void parse(FILE * fp_gerb, const char * text, size_t length, int threads);
+		Gerber(const Gerber * modalState);
+		Gerber(double ImageDPI, double GrowSize, double optScaleX, double optScaleY, ParseMode mode, const FunctionFilter * filter);
+		void startParse();
+		void finishParse(bool isGeometryInitialised);
+		void parseError(const string &msg);
+		void * streamScanner;				// incremental parse: scanner kept between the parts
+		string streamPending;				// incremental parse: incomplete block at the end of the data received
+		static const char * findCompleteBlocks(const char * text, const char * end);
 		void flashAperture(double x, double y);
 		void loadDefaults();
         std::list< Aperture > macro_apertures;
         std::list< Aperture > ad_apertures;
+        std::vector< Aperture * > apertureTable;	// ad_apertures indexed by D-code, 0 if undefined
+        std::map< int, Aperture * > apertureTableLarge;	// D-codes too large for apertureTable
+        Aperture * findAperture(int DCode);
+        void setAperture(int DCode, Aperture * arp);
 
+        // Step and repeat block opened by %SR. Its polygons are instanced at every step when it is closed.
         struct StepRpeatBlock
         {
-        	string buffer;
         	int X;
         	int Y;
-        	double I;
+        	double I;						// step distances in pixels
         	double J;
+        	size_t firstPolygon;			// number of polygons preceding the block
+        	Extents extentsBefore;			// lint mode: extents of the image preceding the block
         } repeat;
+        void stepRepeat(int countX, int countY, double stepI, double stepJ);
+
+        // Block apertures being defined by %AB, the innermost one last.
+        struct BlockAperture
+        {
+        	int DCode;
+        	size_t firstPolygon;			// number of polygons preceding the block
+        	bool isGeometryEnabled;			// restored when the block is closed
+        };
+        std::vector< BlockAperture > openBlocks;
+        void beginBlockAperture(int DCode);
+        void endBlockAperture();
 
 
 	public: //---------------------------
@@ -153,15 +256,30 @@ class Gerber {
 		std::vector< std::string > messages;
 		std::ostringstream errorMessage;			// string of occurring error
 		bool isError;
+		unsigned long apertureLookups;	// number of D-code aperture selections while parsing
+		Extents extents;				// lint mode: bounding box of the image in pixels, instead of polygons
 
 		list<Polygon> polygons;		// Contains a complete polygons list to build an image of this gerber file.
 		list<VertexData *> vertexdata;	// Vertices information used by each new polygon requiring a new set of vertices.
 
-		Gerber(FILE * fp_gerb, double ImageDPI, double GrowSize, double optScaleX, double optScaleY);
+		// Objects whose X2 aperture function is not selected by filter are dropped while parsing.
+		Gerber(FILE * fp_gerb, double ImageDPI, double GrowSize, double optScaleX, double optScaleY, ParseMode mode = PARSE_RENDER, const FunctionFilter * filter = 0);
+		Gerber(const char * text, size_t length, double ImageDPI, double GrowSize, double optScaleX, double optScaleY, int threads = 1, ParseMode mode = PARSE_RENDER, const FunctionFilter * filter = 0);
+
+		// Binary display list of the polygons, see displaylist.h
+		bool saveDisplayList(const char * filename);
+		static Gerber * loadDisplayList(const char * data, size_t length, double ImageDPI, double GrowSize, double optScaleX, double optScaleY);
+
+		// Incremental parsing of a file received in pieces: create the object with beginParse(), give each
+		// piece of any size to parsePart() as it arrives, then call endParse() at the end of the file.
+		// parsePart() returns false when no more data is needed. Errors are reported as by the constructors.
+		static Gerber * beginParse(double ImageDPI, double GrowSize, double optScaleX, double optScaleY, ParseMode mode = PARSE_RENDER, const FunctionFilter * filter = 0);
+		bool parsePart(const char * data, size_t length);
+		void endParse();
 };
 
 
-extern void yyerror( Gerber *g, const char * msg);
+extern void yyerror( Gerber *g, void *scanner, const char * msg);
 
 
 
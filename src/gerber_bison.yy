@@ -17,8 +17,11 @@
 
 
 %defines
+%define api.pure
 %parse-param {Gerber *g}
+%parse-param {void *scanner}
 %lex-param {Gerber *g}
+%lex-param {void *scanner}
 %error-verbose
 %token-table
 
@@ -44,7 +47,7 @@ gerber 				: 	data_block
 					| 	gerber data_block
 
 data_block 			:	'%' paramRS274_list '%'
-				  	|	'%' PARAMETER_AM  MACRONAME am_primitive_list  asterisk  '%'
+				  	|	'%' PARAMETER_AM  MACRONAME am_primitive_list  asterisk  '%' { g->compileMacro(); }
 					|	command_list '*' { g->processDataBlock(); }						// Always process data block immediately after first asterisk
 					| 	'*'																// Allow empty data blocks
 					|	'%'																// Allow empty parameter blocks
@@ -58,6 +61,17 @@ paramRS274_list		:	paramRS274 asterisk
 paramRS274 			:	PARAMETER
 					|	PARAMETER_ADD MACRONAME ',' ad_modifier_list { g->process_AD_block($1);  }
 					|	PARAMETER_ADD MACRONAME { g->process_AD_block($1);  }
+					|	'A' 'B' 'D' NUMBER { g->beginBlockAperture(int($4)); }		// %ABDnn*% opens block aperture Dnn
+					|	'A' 'B' { g->endBlockAperture(); }							// %AB*% closes it
+					|	'S' 'R' { g->stepRepeat(1, 1, 0, 0); }						// %SR*% closes a step and repeat block
+					|	'L' 'M' load_mirror										// %LMN*%, %LMX*%, %LMY*%, %LMXY*% Load Mirroring
+					|	'L' 'R' ad_number { g->loadRotation = $3 * M_PI / 180.0; }		// Load Rotation in degrees anticlockwise
+					|	'L' 'S' ad_number { g->loadScale = $3; }						// Load Scaling
+
+load_mirror			:	'N'			{ g->isLoadMirrorX = false;	g->isLoadMirrorY = false; }
+					|	'X'			{ g->isLoadMirrorX = true;	g->isLoadMirrorY = false; }
+					|	'Y'			{ g->isLoadMirrorX = false;	g->isLoadMirrorY = true; }
+					|	'X' 'Y'		{ g->isLoadMirrorX = true;	g->isLoadMirrorY = true; }
 
 ad_modifier_list 	:	ad_number						{ g->variables.push_back($1); }
 					|	ad_modifier_list 'X' ad_number	{ g->variables.push_back($3); }
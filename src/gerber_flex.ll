@@ -7,13 +7,7 @@
 #include "gerber.h"
 #include "gerber_bison.hh"
 
-#define YY_DECL 	int yylex(Gerber *g)
-
-#define YY_USER_ACTION  \
-	if (g->repeat.X > 1 && g->repeat.Y > 1) \
-	{ \
-		g->repeat.buffer += yytext; \
-	}
+#define YY_DECL 	int yylex(YYSTYPE *yylval_param, Gerber *g, yyscan_t yyscanner)
 
 /*  
  *
@@ -32,6 +26,8 @@ void numberAfterChar(char * str, char c, double *data, double multiplier=1)
 
 /* %option		header-file="lex.yy.h" */
 %option 	stack
+%option 	reentrant
+%option 	bison-bridge
 %option 	noyywrap
 %option 	posix-compat
 
@@ -54,28 +50,28 @@ void numberAfterChar(char * str, char c, double *data, double multiplier=1)
 <*>\n							{	g->currentLine++;					// count the LF and hide from parser
 							}
 <INITIAL,ADblock,AMblock>[0-9]*\.?[0-9]+\.?[0-9]*	{				// get floating point number, and extract extranous '.' followed by digits.
-								yylval.YS_float   = atof(yytext);	// Evaluate number but ignore '+' or '-' prefix as it handler in yylex()
+								yylval->YS_float   = atof(yytext);	// Evaluate number but ignore '+' or '-' prefix as it handler in yylex()
 								if (strchr(yytext,'.') != strrchr(yytext,'.') )  g->warning("extraneous '.' in number");
 								return NUMBER;
 							}
 <AMblock>\$[0-9]+			{
-								yylval.YS_int  = atoi(yytext+1)-1;		// $n Variables identifiers
-								if (yylval.YS_int < 0 ) throw string("variable placeholder must be >= 1");
+								yylval->YS_int  = atoi(yytext+1)-1;		// $n Variables identifiers
+								if (yylval->YS_int < 0 ) throw string("variable placeholder must be >= 1");
 								return VARIABLE;
 							}
-AM							{	yy_push_state(macroname);				// AM paramater syntax
+AM							{	yy_push_state(macroname, yyscanner);	// AM paramater syntax
 								BEGIN(AMblock);							// goto <AMblock> condition, exits on next '%' tocken, see below
-								yy_push_state(macroname);
+								yy_push_state(macroname, yyscanner);
 								return PARAMETER_AM;
 							}
-ADD[0-9]+  					{	yylval.YS_int = atoi(yytext+3);		// ADD paramater syntax (return D code in value)
+ADD[0-9]+  					{	yylval->YS_int = atoi(yytext+3);		// ADD paramater syntax (return D code in value)
 								BEGIN(ADblock);					// goto <ADblock> condition, exits on next '*' tocken, see below
-								yy_push_state(macroname);
+								yy_push_state(macroname, yyscanner);
 								return PARAMETER_ADD;
 							}
 <macroname>[A-Za-z_]+[A-Za-z_0-9]*	{								// a string of the Aperture macro name
 								g->temporaryNameMacro = yytext;				// save string
-								yy_pop_state();
+								yy_pop_state(yyscanner);
 								return MACRONAME;
 							}
 FS.*X[0-9][0-9].*Y[0-9][0-9] 	{  							// FS Format Statement
@@ -91,28 +87,23 @@ IF[^*]+\*					{															// IF, Include file.  Don't return to parser
 								yytext[yyleng-1]=0;			// remove trailing '*'								
 								fopen_s(&yyin, yytext+2,"r");//yyin = fopen_s(yytext+2,"r");
 								if ( ! yyin)	throw string("cannot open include file '")+(yytext+2)+"'";
-								yypush_buffer_state(yy_create_buffer( yyin, YY_BUF_SIZE ));
+								yypush_buffer_state(yy_create_buffer( yyin, YY_BUF_SIZE, yyscanner ), yyscanner);
 							}
-G0*4[^*]*					{	return CODE; }											// G04 command. Skip remainder of data block.
-T[A-Z].[^*]*				{	 }														// Attribute TF commond, continue
+G0*4[^*]*					{	g->processAttribute(yytext); return CODE; }		// G04 command, may hold an X2 attribute. Skip remainder of data block.
+T[A-Z].[^*]*				{	if (yytext[2] == '*') yyless(2);					// X2 attribute command, %TD* has no name
+								g->processAttribute(yytext); }
 ASAXBY						{	g->isAxisSwapped = false; return PARAMETER; }			// Axis Swap
 ASAYBX						{	g->isAxisSwapped = true;
 								g->warning("Ignoring AS (Axis Swap) parameter. A axis = X data, B axis = Y data.");
 								return PARAMETER;
 							}
 SR([XYIJ][-+]?[0-9]*\.?[0-9]+)+ 	{
-//							cout << "\nlast SR block "<<g->repeat.buffer<<"\n";
-							g->repeat.I = 0;
-							g->repeat.J = 0;
-							double x=1,y=1;
+							double x=1,y=1,i=0,j=0;				// Step and Repeat, closes the previous block
 							numberAfterChar(yytext, 'X', &x);
 							numberAfterChar(yytext, 'Y', &y);
-							g->repeat.X = int(x);
-							g->repeat.Y = int(y);
-							numberAfterChar(yytext, 'I', &g->repeat.I);
-							numberAfterChar(yytext, 'J', &g->repeat.J);
-							g->repeat.buffer.erase();
-							g->warning("Ignoring SR (Step and Repeat) parameter");
+							numberAfterChar(yytext, 'I', &i);
+							numberAfterChar(yytext, 'J', &j);
+							g->stepRepeat(int(x), int(y), i, j);
 							return PARAMETER;
 							}
 
@@ -136,7 +127,7 @@ MI(A[01])?(B[01])?			{	bool preA = g->isMirrorAaxis;							// specify mirroring
 							}
 M[0-9]+						{   int i = atoi(yytext+1);
 								if (i == 2 ) { 	g->loadDefaults(); return '*'; }		// M2 reset Gerber parameters and continue reading
-								if (i == 3 ) return 0;									// M3 stop reading program
+								if (i == 3 ) { g->isProgramStopped = true; return 0; }	// M3 stop reading program
 								if (i <= 1 ) return '*';								// M0 / M1 just ignore, and continue reading as normal
 								throw "Unknown "+string(yytext)+" code";
 							}
@@ -165,7 +156,7 @@ PF[^*]*						{	g->imageFilm = yytext[2]; return PARAMETER; 	}		// Image Film str
 <*>[A-Za-z0-9\+%\-/(),\*]	{	return toupper(yytext[0]); }							// return all other valid single characters
 <*>.						{ }															// ignore all invalid characters
 <<EOF>> 					{
-								yypop_buffer_state();
+								yypop_buffer_state(yyscanner);
 								if ( !YY_CURRENT_BUFFER )
 								{
 									yyterminate();
@@ -0,0 +1,439 @@
+/*	DEFLATE (RFC 1951) and gzip (RFC 1952) decompression.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+#include <string.h>
+#include <vector>
+#include <string>
+
+#include "inflate.h"
+
+using namespace std;
+
+
+// CRC-32 lookup table, polynomial 0xEDB88320
+struct CrcTable
+{
+	unsigned long value[256];
+	CrcTable()
+	{
+		for (unsigned long n=0; n < 256; n++)
+		{
+			unsigned long c = n;
+			for (int k=0; k < 8; k++)
+				c = (c & 1) ? 0xEDB88320UL ^ (c >> 1) : c >> 1;
+			value[n] = c;
+		}
+	}
+};
+static const CrcTable crcTable;
+
+unsigned long crc32(unsigned long crc, const unsigned char * data, size_t length)
+{
+	crc = crc ^ 0xFFFFFFFFUL;
+	for (size_t i=0; i < length; i++)
+		crc = crcTable.value[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	return crc ^ 0xFFFFFFFFUL;
+}
+
+
+//
+// Reads the compressed data least significant bit first, as DEFLATE packs it.
+//
+class BitReader
+{
+	public:
+		const unsigned char * p;		// next byte not yet in the bit buffer
+		const unsigned char * end;
+		unsigned long long buffer;
+		int count;						// number of bits in buffer
+
+		BitReader(const unsigned char * data, size_t length) : p(data), end(data + length), buffer(0), count(0) { }
+
+		void fill()
+		{
+			while (count <= 56 && p < end)
+			{
+				buffer |= (unsigned long long)(*p++) << count;
+				count += 8;
+			}
+		}
+		unsigned bits(int n)
+		{
+			if (count < n)
+			{
+				fill();
+				if (count < n)
+					throw string("unexpected end of compressed data");
+			}
+			unsigned value = (unsigned)(buffer & ((1ULL << n) - 1));
+			buffer >>= n;
+			count -= n;
+			return value;
+		}
+		// Skips to the next byte boundary and hands the whole bytes of the bit buffer back to p.
+		void alignToByte()
+		{
+			p -= count / 8;
+			buffer = 0;
+			count = 0;
+		}
+};
+
+
+//
+// Canonical Huffman code. Codes up to FAST_BITS long are decoded with a single table lookup.
+//
+class Huffman
+{
+	public:
+		enum { FAST_BITS = 10, MAX_BITS = 15 };
+		short count[MAX_BITS + 1];			// number of codes of each length
+		short symbol[320];					// symbols ordered by code
+		unsigned short fast[1 << FAST_BITS];	// code length << 9 | symbol, 0 if longer than FAST_BITS
+
+		void build(const unsigned char * lengths, int n);
+		int decode(BitReader &in);
+};
+
+void Huffman::build(const unsigned char * lengths, int n)
+{
+	short offset[MAX_BITS + 2];
+	unsigned nextCode[MAX_BITS + 1];
+
+	memset(count, 0, sizeof(count));
+	memset(fast, 0, sizeof(fast));
+	for (int s=0; s < n; s++)
+		count[lengths[s]]++;
+	count[0] = 0;
+
+	int left = 1;
+	for (int len=1; len <= MAX_BITS; len++)
+	{
+		left <<= 1;
+		left -= count[len];
+		if (left < 0)
+			throw string("invalid Huffman code lengths");
+	}
+
+	offset[1] = 0;
+	nextCode[1] = 0;
+	for (int len=1; len < MAX_BITS; len++)
+	{
+		offset[len + 1] = offset[len] + count[len];
+		nextCode[len + 1] = (nextCode[len] + count[len]) << 1;
+	}
+	for (int s=0; s < n; s++)
+	{
+		int len = lengths[s];
+		if (len == 0)
+			continue;
+		symbol[offset[len]++] = s;
+		unsigned code = nextCode[len]++;
+		if (len > FAST_BITS)
+			continue;
+		unsigned reversed = 0;
+		for (int i=0; i < len; i++)
+			reversed |= ((code >> i) & 1) << (len - 1 - i);
+		for (unsigned r = reversed; r < (1u << FAST_BITS); r += 1u << len)
+			fast[r] = (unsigned short)((len << 9) | s);
+	}
+}
+
+int Huffman::decode(BitReader &in)
+{
+	if (in.count < FAST_BITS)
+		in.fill();
+	unsigned entry = fast[in.buffer & ((1 << FAST_BITS) - 1)];
+	if (entry != 0 && int(entry >> 9) <= in.count)
+	{
+		in.buffer >>= entry >> 9;
+		in.count -= entry >> 9;
+		return entry & 0x1FF;
+	}
+
+	// long code, decoded one bit at a time
+	int code = 0, first = 0, index = 0;
+	for (int len=1; len <= MAX_BITS; len++)
+	{
+		code |= in.bits(1);
+		if (code - count[len] < first)
+			return symbol[index + (code - first)];
+		index += count[len];
+		first += count[len];
+		first <<= 1;
+		code <<= 1;
+	}
+	throw string("invalid Huffman code");
+}
+
+
+//
+// Decompressed output. The last WINDOW_SIZE bytes are kept for back references,
+// the output is handed to the sink whenever the buffer is full.
+//
+class OutputWindow
+{
+	public:
+		enum { WINDOW_SIZE = 32768, BUFFER_SIZE = 8 * 32768, MAX_MATCH = 258 };
+		vector<unsigned char> buffer;
+		size_t pos;
+		size_t flushed;						// bytes of buffer already written to the sink
+		InflateSink &sink;
+		unsigned long crc;
+		bool isStopped;
+
+		OutputWindow(InflateSink &sink) : buffer(BUFFER_SIZE), pos(0), flushed(0), sink(sink), crc(0), isStopped(false) { }
+
+		void flush()
+		{
+			if (pos > flushed && !isStopped)
+			{
+				crc = crc32(crc, &buffer[flushed], pos - flushed);
+				isStopped = !sink.write(&buffer[flushed], pos - flushed);
+			}
+			flushed = pos;
+		}
+		// makes room for n more bytes
+		void reserve(size_t n)
+		{
+			if (pos + n <= BUFFER_SIZE)
+				return;
+			flush();
+			memmove(&buffer[0], &buffer[pos - WINDOW_SIZE], WINDOW_SIZE);
+			pos = flushed = WINDOW_SIZE;
+		}
+};
+
+
+static const short lengthBase[29] = {
+		3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+		35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const short lengthExtra[29] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+		3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const unsigned short distanceBase[30] = {
+		1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+		257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const short distanceExtra[30] = {
+		0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+		7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+
+// Decodes the literals and matches of a compressed block until its end of block code.
+static void inflateCodes(BitReader &in, OutputWindow &out, Huffman &lengthCode, Huffman &distanceCode)
+{
+	while (!out.isStopped)
+	{
+		int s = lengthCode.decode(in);
+		if (s < 256)
+		{
+			out.reserve(1);
+			out.buffer[out.pos++] = (unsigned char)s;
+			continue;
+		}
+		if (s == 256)
+			return;
+		s -= 257;
+		if (s >= 29)
+			throw string("invalid literal/length code");
+		int length = lengthBase[s] + in.bits(lengthExtra[s]);
+		int d = distanceCode.decode(in);
+		if (d >= 30)
+			throw string("invalid distance code");
+		size_t distance = distanceBase[d] + in.bits(distanceExtra[d]);
+		out.reserve(length);
+		if (distance > out.pos)
+			throw string("invalid distance, too far back");
+		unsigned char * to = &out.buffer[out.pos];
+		const unsigned char * from = to - distance;
+		for (int i=0; i < length; i++)		// byte by byte, the match may overlap the output
+			to[i] = from[i];
+		out.pos += length;
+	}
+}
+
+
+size_t inflate(const unsigned char * data, size_t length, InflateSink &sink, unsigned long * crc)
+{
+	static const unsigned char codeLengthOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+	BitReader in(data, length);
+	OutputWindow out(sink);
+	Huffman lengthCode, distanceCode;
+	bool isLast = false;
+
+	while (!isLast && !out.isStopped)
+	{
+		isLast = in.bits(1) != 0;
+		int type = in.bits(2);
+		if (type == 0)				// stored block
+		{
+			in.alignToByte();
+			if (in.end - in.p < 4)
+				throw string("unexpected end of compressed data");
+			size_t n = in.p[0] | (in.p[1] << 8);
+			if (size_t(in.p[2] | (in.p[3] << 8)) != (~n & 0xFFFF))
+				throw string("invalid stored block length");
+			in.p += 4;
+			if (size_t(in.end - in.p) < n)
+				throw string("unexpected end of compressed data");
+			while (n > 0)
+			{
+				size_t k = min(n, size_t(OutputWindow::BUFFER_SIZE - OutputWindow::WINDOW_SIZE));
+				out.reserve(k);
+				memcpy(&out.buffer[out.pos], in.p, k);
+				out.pos += k;
+				in.p += k;
+				n -= k;
+			}
+		}
+		else if (type == 1)			// fixed Huffman codes
+		{
+			unsigned char lengths[288 + 30];
+			memset(lengths, 8, 144);
+			memset(lengths + 144, 9, 112);
+			memset(lengths + 256, 7, 24);
+			memset(lengths + 280, 8, 8);
+			memset(lengths + 288, 5, 30);
+			lengthCode.build(lengths, 288);
+			distanceCode.build(lengths + 288, 30);
+			inflateCodes(in, out, lengthCode, distanceCode);
+		}
+		else if (type == 2)			// dynamic Huffman codes
+		{
+			int nlen = in.bits(5) + 257;
+			int ndist = in.bits(5) + 1;
+			int ncode = in.bits(4) + 4;
+			if (nlen > 286 || ndist > 30)
+				throw string("invalid dynamic block code counts");
+			unsigned char lengths[320];
+			memset(lengths, 0, 19);
+			for (int i=0; i < ncode; i++)
+				lengths[codeLengthOrder[i]] = in.bits(3);
+			lengthCode.build(lengths, 19);
+
+			int i = 0;
+			while (i < nlen + ndist)
+			{
+				int s = lengthCode.decode(in);
+				int repeat = 1;
+				unsigned char value = 0;
+				if (s < 16)
+					value = s;
+				else if (s == 16)
+				{
+					if (i == 0)
+						throw string("repeated code length without a previous length");
+					value = lengths[i - 1];
+					repeat = 3 + in.bits(2);
+				}
+				else if (s == 17)
+					repeat = 3 + in.bits(3);
+				else
+					repeat = 11 + in.bits(7);
+				if (i + repeat > nlen + ndist)
+					throw string("too many code lengths");
+				while (repeat--)
+					lengths[i++] = value;
+			}
+			if (lengths[256] == 0)
+				throw string("missing end of block code");
+			lengthCode.build(lengths, nlen);
+			distanceCode.build(lengths + nlen, ndist);
+			inflateCodes(in, out, lengthCode, distanceCode);
+		}
+		else
+			throw string("invalid compressed block type");
+	}
+	out.flush();
+	if (crc)
+		*crc = out.crc;
+	if (out.isStopped)
+		return 0;
+	return (in.p - data) - in.count / 8;
+}
+
+
+// Returns the size of the gzip member header at /data, and its file name in *name.
+static size_t gzipHeader(const unsigned char * data, size_t length, string * name)
+{
+	if (length < 18 || data[0] != 0x1F || data[1] != 0x8B)
+		throw string("not a gzip file");
+	if (data[2] != 8)
+		throw string("unsupported gzip compression method");
+	int flags = data[3];
+	size_t n = 10;
+	if (flags & 4)				// FEXTRA
+	{
+		if (n + 2 > length)	throw string("truncated gzip header");
+		n += 2 + (data[n] | (data[n + 1] << 8));
+	}
+	if (flags & 8)				// FNAME
+	{
+		size_t start = n;
+		while (n < length && data[n] != 0)	n++;
+		if (name)	name->assign((const char *)data + start, n - start);
+		n++;
+	}
+	if (flags & 16)				// FCOMMENT
+	{
+		while (n < length && data[n] != 0)	n++;
+		n++;
+	}
+	if (flags & 2)				// FHCRC
+		n += 2;
+	if (n > length)
+		throw string("truncated gzip header");
+	return n;
+}
+
+string gzipName(const unsigned char * data, size_t length)
+{
+	string name;
+	try
+	{
+		gzipHeader(data, length, &name);
+	}
+	catch (const string &)
+	{
+	}
+	return name;
+}
+
+bool gunzip(const unsigned char * data, size_t length, InflateSink &sink)
+{
+	size_t n = 0;
+	// a gzip file may hold several members, decompressed as one stream
+	while (length - n >= 18 && data[n] == 0x1F && data[n + 1] == 0x8B)
+	{
+		n += gzipHeader(data + n, length - n, 0);
+		unsigned long crc;
+		size_t used = inflate(data + n, length - n, sink, &crc);
+		if (used == 0)
+			return false;
+		n += used;
+		if (length - n < 8)
+			throw string("truncated gzip trailer");
+		const unsigned char * t = data + n;
+		unsigned long expected = t[0] | (t[1] << 8) | (t[2] << 16) | ((unsigned long)t[3] << 24);
+		if (crc != expected)
+			throw string("gzip CRC error");
+		n += 8;
+	}
+	if (n == 0)
+		throw string("not a gzip file");
+	return true;
+}
@@ -0,0 +1,50 @@
+/*	DEFLATE (RFC 1951) and gzip (RFC 1952) decompression.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+#ifndef INFLATE_H_
+#define INFLATE_H_
+
+#include <stddef.h>
+#include <string>
+
+// Receives decompressed data in the order it is produced.
+// write() returns false to stop the decompression, e.g. when the reader has gone.
+class InflateSink
+{
+	public:
+		virtual bool write(const unsigned char * data, size_t length) = 0;
+		virtual ~InflateSink() { }
+};
+
+// Computes the CRC-32 of the zip and gzip formats, /crc is the value of the preceding data.
+unsigned long crc32(unsigned long crc, const unsigned char * data, size_t length);
+
+// Decompresses raw DEFLATE data held in memory, starting at /data, to /sink.
+// Returns the number of compressed bytes used, or 0 if the sink stopped the decompression.
+// Throws a string describing the problem if the data is corrupt or truncated.
+// The CRC-32 of the output is returned in *crc when crc is not 0.
+size_t inflate(const unsigned char * data, size_t length, InflateSink &sink, unsigned long * crc = 0);
+
+// Decompresses all the members of a gzip file held in memory to /sink, checking their CRC.
+// Returns false if the sink stopped the decompression. Throws a string on errors.
+bool gunzip(const unsigned char * data, size_t length, InflateSink &sink);
+
+// Returns the original file name stored in a gzip header, or an empty string.
+std::string gzipName(const unsigned char * data, size_t length);
+
+
+#endif  // INFLATE_H_
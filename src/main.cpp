@@ -5,6 +5,7 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <set>
 #include <string>
 #include <math.h>
 #include <limits.h>
@@ -20,12 +21,21 @@
 //#endif
 #include <stdarg.h>
 #include <string.h>
+#ifdef __linux__
+#include <unistd.h>
+#else
+#define HAVE_STRUCT_TIMESPEC
+#endif
+#include <pthread.h>
 
 using namespace std;
 
 #include "polygon.h"
 #include "apertures.h"
 #include "gerber.h"
+#include "mappedfile.h"
+#include "archive.h"
+#include "displaylist.h"
 
 unsigned char * DEGUB_bitmap_ptr_end;
 
@@ -41,6 +51,14 @@ const char *help_message=
 "  -a, --area           Show total dark area of TIFF in square centimeters.\n"
 "  -q, --quiet          Suppress warnings and non critical messages.\n"
 "  -t                   Test only. Process Gerber file without writing TIFF.\n"
+"  -l, --lint           Check the gerber files only: report errors, warnings and\n"
+"                       the extents of each file, computed from the coordinates\n"
+"                       and aperture sizes. No polygons are made, which is much\n"
+"                       faster than -t. Exits with 1 if any file has errors.\n"
+"  --plan[=json]        Predict the rendering without doing it: image size, TIFF\n"
+"                       strips, polygon and vertex counts, memory used by the\n"
+"                       scan line data and the rendering and encoding time.\n"
+"                       Printed as a JSON object with --plan=json.\n"
 "  -o, --output=FILE    Set name of output TIFF to FILE. If gerber-file is\n"
 "                       specified then default is <file1>.tiff\n"
 "                       This option is required when no gerber-file specified.\n"
@@ -59,6 +77,32 @@ const char *help_message=
 "  --strip-rois=N       Specify N rows per strip in TIFF. Default 512\n"
 "  --scale-y=FACTOR     Scale image in Y axis by FACTOR. Default 1\n"
 "  --scale-x=FACTOR     Scale image in X axis by FACTOR. Default 1\n"
+"  --include-function=LIST\n"
+"                       Draw only the objects whose Gerber X2 .AperFunction\n"
+"                       attribute is in the comma separated LIST, e.g.\n"
+"                       SMDPad,ComponentPad. Objects without the attribute are\n"
+"                       then dropped. Other objects are dropped while parsing.\n"
+"  --exclude-function=LIST\n"
+"                       Drop the objects whose .AperFunction is in LIST,\n"
+"                       e.g. Fiducial. Both options may be combined.\n"
+"\n"
+"Performance options: \n"
+"  -j, --threads=N      Parse up to N gerber files concurrently.\n"
+"                       Default is the number of processors.\n"
+"  -m, --mmap           Memory map the gerber files and decode coordinate data\n"
+"                       blocks with a fast scanner instead of the full parser.\n"
+"                       Large files are split in chunks parsed by the threads\n"
+"                       left over from -j.\n"
+"  -z, --archive=FILE   Read the gerber files from the zip, gzip, tar.gz or tar\n"
+"                       archive FILE. They are decompressed while being parsed,\n"
+"                       without temporary files. file1 file2... then name the\n"
+"                       archive members, wildcards '*' and '?' are allowed.\n"
+"                       All members are read when none are named.\n"
+"  -d, --save-display-list\n"
+"                       Save the parsed polygons of each gerber file to the\n"
+"                       binary display list <file>.g2dl. A display list given\n"
+"                       as input file is rendered without parsing, with the\n"
+"                       --grow and --scale options it was saved with.\n"
 "\n"
 "Where file1 file2... are gerber files rendered as overlays to a single bitmap.\n"
 "Standard input is read if no gerber files specified and --output is specified.\n"
@@ -175,6 +219,218 @@ void horizontalLine( int x1, int x2, unsigned char *buffer, Polarity_t polarity)
 } // end HorizontalLine()
 
 
+//**********************************************************
+// Parallel parsing of the input files.
+// Every Gerber object owns its own reentrant scanner and parser, so the
+// input files are handed to a small pool of worker threads. Results are
+// stored by file index so the merge order remains the command line order.
+//**********************************************************
+struct ParseJob
+{
+	FILE * file;
+	MappedFile * mapped;			// used instead of file when the input is memory mapped
+	bool isStream;					// file is a pipe from the archive decompression, closed when parsed
+	bool isDisplayList;				// mapped is a display list, loaded instead of parsed
+	Gerber * gerber;
+};
+
+struct ParseQueue
+{
+	vector<ParseJob> jobs;
+	unsigned next;					// index of the next job to be taken by a worker
+	pthread_mutex_t lock;
+	double dotsPerInch, growSize, scaleX, scaleY;
+	int chunkThreads;				// threads used to parse each memory mapped file
+	ParseMode mode;
+	const FunctionFilter * filter;	// X2 aperture functions drawn, 0 to draw all objects
+};
+
+// Parse a pipe or the standard input incrementally, the blocks are parsed as soon as they are received
+Gerber * parseStream(FILE * file, ParseQueue * queue)
+{
+	Gerber * gerber = Gerber::beginParse(queue->dotsPerInch, queue->growSize, queue->scaleX, queue->scaleY, queue->mode, queue->filter);
+	vector<char> buffer(1<<16);
+	size_t length;
+	while ((length = fread(&buffer[0], 1, buffer.size(), file)) > 0)
+		if (!gerber->parsePart(&buffer[0], length))
+			break;
+	gerber->endParse();
+	return gerber;
+}
+
+void * parseWorker(void * arg)
+{
+	ParseQueue * queue = (ParseQueue *)arg;
+	while (1)
+	{
+		pthread_mutex_lock(&queue->lock);
+		unsigned i = queue->next++;
+		pthread_mutex_unlock(&queue->lock);
+		if (i >= queue->jobs.size())
+			break;
+		ParseJob &job = queue->jobs[i];
+		if (job.isDisplayList)
+			job.gerber = Gerber::loadDisplayList(job.mapped->data, job.mapped->size, queue->dotsPerInch, queue->growSize, queue->scaleX, queue->scaleY);
+		else if (job.isStream || job.file == stdin)
+			job.gerber = parseStream(job.file, queue);
+		else if (job.mapped)
+			job.gerber = new Gerber(job.mapped->data, job.mapped->size, queue->dotsPerInch, queue->growSize, queue->scaleX, queue->scaleY, queue->chunkThreads, queue->mode, queue->filter);
+		else
+			job.gerber = new Gerber(job.file, queue->dotsPerInch, queue->growSize, queue->scaleX, queue->scaleY, queue->mode, queue->filter);
+		if (job.isStream)
+		{
+			fclose(job.file);		// lets the decompression go on with the next member if the parser stopped early
+			job.file = 0;
+		}
+	}
+	return 0;
+}
+
+int processorCount()
+{
+#ifdef __linux__
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+	long n = pthread_num_processors_np();
+#endif
+	return n < 1 ? 1 : (int)n;
+}
+
+// Parse all queued jobs using up to threadCount threads.
+// The calling thread does the work itself when only one thread is needed.
+void parseAll(ParseQueue &queue, int threadCount)
+{
+	queue.next = 0;
+	pthread_mutex_init(&queue.lock, 0);
+	if (threadCount > (int)queue.jobs.size())
+		threadCount = queue.jobs.size();
+
+	vector<pthread_t> threads;
+	for (int i=1; i < threadCount; i++)
+	{
+		pthread_t tid;
+		if (pthread_create(&tid, 0, parseWorker, &queue) == 0)
+			threads.push_back(tid);
+	}
+	parseWorker(&queue);
+	for (unsigned i=0; i < threads.size(); i++)
+		pthread_join(threads[i], 0);
+	pthread_mutex_destroy(&queue.lock);
+}
+
+
+
+
+//**********************************************************
+// Plan mode: predicts the rendering of the polygons, parsed without their scan line data.
+// The scan line data of each set of vertices is estimated from its edges. Polygons too large for
+// it are scanned from their edges while rendering, which is paid again by every polygon using them.
+// The data is held from the first row of its first polygon to the last row of its last polygon,
+// the span table memory is the largest total held at any row.
+// The times come from a cost model calibrated on a 3 GHz x86-64 core:
+//  - scan line data: per vertex (edge table) and per intersection made
+//  - rendering: per polygon row and span drawn, and the insertion of each polygon in the
+//    active polygon set, proportional to log2(A) for A polygons active on average
+//  - encoding: per byte of bitmap cleared and written
+//**********************************************************
+static const double SECONDS_PER_VERTEX = 250e-9;
+static const double SECONDS_PER_INTERSECTION = 12e-9;
+static const double SECONDS_PER_POLYGON_ROW = 14e-9;
+static const double SECONDS_PER_SPAN = 12e-9;
+static const double SECONDS_PER_ACTIVE_INSERT = 60e-9;
+static const double SECONDS_PER_BITMAP_BYTE = 1e-9;
+
+struct PlanVertexSet
+{
+	size_t intersections;			// estimated scan line intersections
+	int firstRow;					// rows the scan line data is held while rendering
+	int lastRow;
+	int polygons;					// using the set
+};
+
+void printPlan(list<Polygon> &polygons, unsigned imageWidth, unsigned imageHeight, unsigned rowsPerStrip, double parseSeconds, bool isJson)
+{
+	map<VertexData *, PlanVertexSet> vertexSets;
+	unsigned long long vertexCount = 0, intersections = 0, polygonRows = 0, spans = 0;
+	for (list<Polygon>::iterator it = polygons.begin(); it != polygons.end(); it++)		// in ascending pixelMinY
+	{
+		map<VertexData *, PlanVertexSet>::iterator set = vertexSets.find(it->vdata);
+		bool isNewSet = (set == vertexSets.end());
+		if (isNewSet)
+		{
+			PlanVertexSet s = { it->vdata->estimateIntersections(), it->pixelMinY, it->pixelMaxY, 0 };
+			set = vertexSets.insert(make_pair(it->vdata, s)).first;
+			vertexCount += it->vdata->vertices.size();
+		}
+		set->second.lastRow = max(set->second.lastRow, it->pixelMaxY);
+		set->second.polygons++;
+		if ((isNewSet && !it->vdata->isRectangle()) || VertexData::isActiveEdgeScan(set->second.intersections))
+			intersections += set->second.intersections;
+		polygonRows += it->pixelMaxY - it->pixelMinY + 1;
+		spans += set->second.intersections / 2;
+	}
+
+	// scan line data made and freed while rendering, by row
+	vector< pair<int, double> > changes;
+	for (map<VertexData *, PlanVertexSet>::iterator it = vertexSets.begin(); it != vertexSets.end(); it++)
+	{
+		double bytes = it->first->isRectangle() ? 0
+				: VertexData::isActiveEdgeScan(it->second.intersections) || it->first->isChordScan(it->second.polygons)
+				? double(it->first->vertices.size() + 2 * it->first->arcs.size()) * sizeof(Edge)
+				: double(it->second.intersections + it->first->height() + 1) * sizeof(unsigned short);	// at most, see CompactScanLines
+		changes.push_back(make_pair(it->second.firstRow, bytes));
+		changes.push_back(make_pair(it->second.lastRow + 1, -bytes));
+	}
+	sort(changes.begin(), changes.end());
+	double spanTableBytes = 0;
+	double heldBytes = 0;
+	for (unsigned i=0; i < changes.size(); i++)
+	{
+		heldBytes += changes[i].second;
+		spanTableBytes = max(spanTableBytes, heldBytes);
+	}
+
+	unsigned strips = (imageHeight + rowsPerStrip - 1) / rowsPerStrip;
+	double stripBytes = double(imageWidth / 8) * rowsPerStrip;
+	double bitmapBytes = double(imageWidth / 8) * imageHeight;
+	double memoryBytes = spanTableBytes + stripBytes + vertexCount * sizeof(Point)
+			+ polygons.size() * (sizeof(Polygon) + 2 * sizeof(void *));
+	double activePolygons = max(2.0, double(polygonRows) / imageHeight);
+	double scanLineSeconds = vertexCount * SECONDS_PER_VERTEX + intersections * SECONDS_PER_INTERSECTION;
+	double renderSeconds = polygonRows * SECONDS_PER_POLYGON_ROW + spans * SECONDS_PER_SPAN
+			+ polygons.size() * log2(activePolygons) * SECONDS_PER_ACTIVE_INSERT;
+	double encodeSeconds = bitmapBytes * SECONDS_PER_BITMAP_BYTE;
+	double totalSeconds = parseSeconds + scanLineSeconds + renderSeconds + encodeSeconds;
+
+	if (isJson)
+	{
+		printf("{\"image_width\": %u, \"image_height\": %u, \"strips\": %u, \"rows_per_strip\": %u, "
+				"\"polygons\": %lu, \"vertex_sets\": %lu, \"vertices\": %llu, \"scan_line_intersections\": %llu, "
+				"\"span_table_bytes\": %.0f, \"strip_buffer_bytes\": %.0f, \"memory_bytes\": %.0f, "
+				"\"parse_seconds\": %.3f, \"scan_line_seconds\": %.3f, \"render_seconds\": %.3f, \"encode_seconds\": %.3f, \"total_seconds\": %.3f}\n"
+				,imageWidth, imageHeight, strips, rowsPerStrip
+				,(unsigned long)polygons.size(), (unsigned long)vertexSets.size(), vertexCount, intersections
+				,spanTableBytes, stripBytes, memoryBytes
+				,parseSeconds, scanLineSeconds, renderSeconds, encodeSeconds, totalSeconds);
+		return;
+	}
+	printf ("Plan\n"
+			"  size (pixels):             %u x %u\n"
+			"  TIFF strips:               %u of %u rows\n"
+			"  polygons:                  %lu\n"
+			"  vertex sets:               %lu (%llu vertices)\n"
+			"  scan line intersections:   %llu\n"
+			"  span tables, peak (MB):    %.1f\n"
+			"  strip buffer (MB):         %.1f\n"
+			"  predicted memory (MB):     %.1f\n"
+			"  predicted time (sec):      %.2f (parse %.2f, scan lines %.2f, render %.2f, encode %.2f)\n"
+			,imageWidth, imageHeight, strips, rowsPerStrip
+			,(unsigned long)polygons.size(), (unsigned long)vertexSets.size(), vertexCount, intersections
+			,spanTableBytes / 0x100000, stripBytes / 0x100000, memoryBytes / 0x100000
+			,totalSeconds, parseSeconds, scanLineSeconds, renderSeconds, encodeSeconds);
+}
+
+
 
 
 //---------------------------------------------------------------------------------
@@ -196,6 +452,14 @@ int main (int argc, char **argv)
 	double optGrowSize = 0;
 	double optScaleX = 1;
 	double optScaleY = 1;
+	int optThreads = 0;
+	bool  optMemoryMap = false;
+	const char * optArchive = 0;
+	bool  optSaveDisplayList = false;
+	bool  optLint = false;
+	bool  optPlan = false;
+	bool  optPlanJson = false;
+	FunctionFilter functionFilter;
 	unsigned int bytesPerScanline;
 	unsigned int bitmapBytes;
 	unsigned char * bitmap;
@@ -247,12 +511,20 @@ int main (int argc, char **argv)
 			{"boarder-mm", required_argument, 0, 'b'},
 			{"boarder-pixels", required_argument, 0, 7},
 			{"rotation", required_argument, 0, 8},
+			{"threads", required_argument, 0, 'j'},
+			{"mmap",    no_argument, 	   0, 'm'},
+			{"archive", required_argument, 0, 'z'},
+			{"save-display-list", no_argument, 0, 'd'},
+			{"lint",    no_argument, 	   0, 'l'},
+			{"plan",    optional_argument, 0, 9},
+			{"include-function", required_argument, 0, 10},
+			{"exclude-function", required_argument, 0, 11},
 			{0, 0, 0, 0}
         };
         // getopt_long stores the option index here.
         int option_index = 0;
 
-        int c = getopt_long (argc, argv, "G:b:o:p:atvnq",
+        int c = getopt_long (argc, argv, "G:b:o:p:j:z:atvnqmdl",
 							long_options, &option_index);
 
 		if (c == EOF)		break;
@@ -260,6 +532,23 @@ int main (int argc, char **argv)
 		switch (c)
 		{
 
+		case 10:
+		case 11:
+			for (const char * p = optarg; *p; )
+			{
+				const char * comma = strchr(p, ',');
+				string function = comma ? string(p, comma - p) : string(p);
+				(c == 10 ? functionFilter.include : functionFilter.exclude).insert(function);
+				p = comma ? comma + 1 : p + function.size();
+			}
+		  break;
+		case 9:
+			optPlan = true;
+			if (optarg && strcmp(optarg, "json") == 0)
+				optPlanJson = true;
+			else if (optarg)
+				error(string("unknown --plan format ") + optarg);
+		  break;
 		case 8:
 			optRotation = atof(optarg);
 		  break;
@@ -312,6 +601,21 @@ int main (int argc, char **argv)
 		case 'o':
 			outputFilename = optarg;
 		  break;
+		case 'j':
+			optThreads = atoi(optarg);
+		  break;
+		case 'm':
+			optMemoryMap = true;
+		  break;
+		case 'z':
+			optArchive = optarg;
+		  break;
+		case 'd':
+			optSaveDisplayList = true;
+		  break;
+		case 'l':
+			optLint = true;
+		  break;
 		case '?':
 		case ':':
 		  fprintf (stderr, "Try 'gerb2tiff --help' for more information.\n");
@@ -321,9 +625,13 @@ int main (int argc, char **argv)
 	}
 
 	if (optVerbose > 0 ) optQuiet = false;			// if user wants verbose, then cancel quiet option
+	if (optLint)		optTestOnly = true;
+	if (optPlan)		optTestOnly = true;
+	if (optPlanJson)	{ optQuiet = true; optVerbose = 0; }		// only the JSON object is printed
 
 	if (imageDPI < 1)		error(string("DPI setting must be >= 1"));
 	if (optBoarder < 0)		error(string("boarder setting must be >= 0"));
+	if (optThreads < 1)		optThreads = processorCount();
 
 	// correct the units for some options
 	if ( optGrowUnitsMillimeters )
@@ -334,15 +642,63 @@ int main (int argc, char **argv)
     list<Gerber *> gerbers;			// pointer to the list of Gerber object
 
     bool isStandardInput = false;
-	if (optind == argc)
+	if (optind == argc && optArchive == 0)
 		isStandardInput = true;
 
 
-	int first_optind = optind;
-	
+	ParseQueue queue;
+	queue.dotsPerInch = imageDPI;
+	queue.growSize = optGrowSize;
+	queue.scaleX = optScaleX;
+	queue.scaleY = optScaleY;
+	queue.mode = optLint ? PARSE_LINT : optPlan ? PARSE_PLAN : PARSE_RENDER;
+	bool isFunctionFiltered = !functionFilter.include.empty() || !functionFilter.exclude.empty();
+	queue.filter = isFunctionFiltered ? &functionFilter : 0;
+
+	// open all the input files first, they are parsed together afterwards
+	vector<string> inputfiles;
+	Archive archive;
+	if (optArchive)
+	{
+		if (!archive.open(optArchive))
+			error(archive.error);
+		// select the members named on the command line, in archive order
+		vector<unsigned> selected;
+		for (unsigned i=0; i < archive.members.size(); i++)
+		{
+			bool isSelected = (optind == argc);
+			for (int k=optind; k < argc && !isSelected; k++)
+				isSelected = Archive::match(argv[k], archive.members[i].name.c_str());
+			if (isSelected)
+				selected.push_back(i);
+		}
+		if (selected.empty())
+			error(string("no matching gerber files in archive ") + optArchive);
+		inputfile = optArchive;
+		if ( outputFilename.empty())
+				outputFilename = inputfile + ".tiff";
+
+		vector<FILE *> files;
+		archive.stream(selected, files);
+		for (unsigned i=0; i < selected.size(); i++)
+		{
+			if (files[i] == 0)
+				error(archive.error);
+			ParseJob job;
+			job.file = files[i];
+			job.mapped = 0;
+			job.isStream = true;
+			job.isDisplayList = false;
+			job.gerber = 0;
+			queue.jobs.push_back(job);
+			inputfiles.push_back(archive.members[selected[i]].name);
+		}
+		optind = argc;
+	}
 	for(; optind < argc || isStandardInput; optind++)
 	{
 		FILE *file = 0;
+		MappedFile *mapped = 0;
 		if ( isStandardInput )
 		{
 			file = stdin;
@@ -358,46 +714,138 @@ int main (int argc, char **argv)
 			inputfile = argv[optind];
 			if ( outputFilename.empty())
 					outputFilename = inputfile + ".tiff";
+			// display lists are always used from a mapping, gerber files only with --mmap
+			mapped = new MappedFile;
+			if (!mapped->map(argv[optind])		// not a regular file, read it through stdio
+					|| (!optMemoryMap && !isDisplayList(mapped->data, mapped->size)))
+			{
+				delete mapped;
+				mapped = 0;
+			}
+			if (mapped == 0)
+			{
 #ifndef __linux__
-			fopen_s(&file, argv[optind], "rb");
+				fopen_s(&file, argv[optind], "rb");
 #else
-			file = fopen( argv[optind], "rb");
+				file = fopen( argv[optind], "rb");
 #endif
-			if (file == NULL)
-					error( string("cannot open input file ")+inputfile );
-			if (!optQuiet)
-			{
-				if (optind == first_optind)			cout << "gerb2tiff: ";
-				if (!optQuiet && optind > first_optind)	cout << "+ ";
-				cout << inputfile << " "<<flush;
+				if (file == NULL)
+						error( string("cannot open input file ")+inputfile );
 			}
 		}
 
-		gerbers.push_back( new Gerber(file, imageDPI, optGrowSize, optScaleX, optScaleY) );
+		ParseJob job;
+		job.file = file;
+		job.mapped = mapped;
+		job.isStream = false;
+		job.isDisplayList = mapped && isDisplayList(mapped->data, mapped->size);
+		if (job.isDisplayList && isFunctionFiltered)
+			error(inputfile + " is a display list, its objects cannot be selected by their function");
+		job.gerber = 0;
+		queue.jobs.push_back(job);
+		inputfiles.push_back(inputfile);
 
+		if ( isStandardInput )
+			break;
+	}
+
+	queue.chunkThreads = max(1, optThreads / max(1, (int)queue.jobs.size()));
+	clock_t parse_clock = clock();
+	parseAll(queue, optThreads);
+	double parseSeconds = ((double) (clock() - parse_clock)) / CLOCKS_PER_SEC;
+	if (!archive.finish())
+		error(archive.error);
+	unsigned long apertureLookups = 0;
+	bool isLintFailed = false;
+
+	for (unsigned k=0; k < queue.jobs.size(); k++)
+	{
+		Gerber * gerber = queue.jobs[k].gerber;
 		if (! isStandardInput)
-			fclose(file);
+		{
+			if (queue.jobs[k].file)
+				fclose(queue.jobs[k].file);
+			delete queue.jobs[k].mapped;
+			if (!optQuiet)
+			{
+				if (k == 0)			cout << "gerb2tiff: ";
+				if (!optQuiet && k > 0)	cout << "+ ";
+				cout << inputfiles[k] << " "<<flush;
+			}
+		}
+
+		gerbers.push_back( gerber );
+		apertureLookups += gerber->apertureLookups;
 
 		// print all warning messages
-		for (int i=0; i < gerbers.back()->messages.size() && !optQuiet; i++)
+		for (int i=0; i < gerber->messages.size() && !optQuiet; i++)
 		{
 			if (i==0) std::cout <<"\n";
-			std::cout <<"("<<inputfile<<") "<<gerbers.back()->messages[i]<<endl;	    		// print messages if any
+			std::cout <<"("<<inputfiles[k]<<") "<<gerber->messages[i]<<endl;	    		// print messages if any
 		}
-		// print error messages and abort
-		if (gerbers.back()->isError)
+		// print error messages and abort, lint mode goes on with the next file
+		if (gerber->isError)
 		{
-			std::cout <<"\n("<<inputfile<<") "<<gerbers.back()->errorMessage.str() << endl;
-			return 1;		// exit program
+			std::cout <<"\n("<<inputfiles[k]<<") "<<gerber->errorMessage.str() << endl;
+			if (!optLint)
+				return 1;		// exit program
+			isLintFailed = true;
+			continue;
 		}
-		if ( isStandardInput )
-			break;
 
+		if (optLint)
+		{
+			if (gerber->messages.empty() && !optQuiet)	std::cout <<"\n";
+			const Extents &e = gerber->extents;		// pixels, y axis pointing down
+			if (e.empty())
+				std::cout <<"("<<inputfiles[k]<<") extents: empty"<<endl;
+			else
+				printf("(%s) extents: X %.4f .. %.4f  Y %.4f .. %.4f mm  (%.4f x %.4f mm)\n", inputfiles[k].c_str()
+						,e.minx * 25.4/imageDPI, e.maxx * 25.4/imageDPI, -e.maxy * 25.4/imageDPI, -e.miny * 25.4/imageDPI
+						,(e.maxx - e.minx) * 25.4/imageDPI, (e.maxy - e.miny) * 25.4/imageDPI);
+			fflush(stdout);
+			continue;
+		}
+
+		if (optSaveDisplayList)
+		{
+			string name = inputfiles[k];
+			if (optArchive)			// next to the archive, named after the member
+			{
+				replace(name.begin(), name.end(), '/', '_');
+				name = string(optArchive) + "." + name;
+			}
+			else if (isStandardInput)
+				name = outputFilename;
+			if (!gerber->saveDisplayList((name + ".g2dl").c_str()))
+			{
+				std::cout <<"\n("<<inputfiles[k]<<") "<<gerber->errorMessage.str() << endl;
+				return 1;
+			}
+		}
+	}
+
+	if (optLint)
+	{
+		if (optVerbose >= 1)
+			printf ("Parse data\n"
+					"  time (sec):                %.2f\n"
+					,parseSeconds);
+		return isLintFailed ? 1 : 0;
 	}
 
 	if (!optTestOnly  && !optQuiet)		cout << "-> "<<outputFilename;
 	if (!optQuiet)						cout << endl;
 
+	if (optVerbose >= 1)
+	{
+		printf ("Parse data\n"
+				"  time (sec):                %.2f\n"
+				"  aperture lookups:          %lu (%.0f per second)\n"
+				,parseSeconds
+				,apertureLookups, (parseSeconds > 0) ? apertureLookups / parseSeconds : 0.0);
+	}
+
 	int miny =  INT_MAX;			// holds min and max dimentions of the occupied gerber images (superimposed)
 	int minx =  INT_MAX;
 	int maxy =  INT_MIN;
@@ -488,6 +936,12 @@ int main (int argc, char **argv)
 	}
     fflush(stdout);
 
+	if (optPlan)
+	{
+		printPlan(globalPolygons, imageWidth, imageHeight, rowsPerStrip, parseSeconds, optPlanJson);
+		return 0;
+	}
+
 	if (optTestOnly)	// stop here on testing or if no Polygons to draw
 	{
 		if (optVerbose)
@@ -562,7 +1016,12 @@ int main (int argc, char **argv)
 
     int stripCounter = 0;
 	list<Polygon>::iterator polyIterator = globalPolygons.begin();
-    list<PolygonReference >  activePolys;
+    multiset<PolygonReference>  activePolys;
+
+	// The scan line data of a set of vertices is made when its first polygon becomes active,
+	// and freed when its last polygon is done, so only the data of the current strip is held.
+	for (list<Polygon>::iterator it = globalPolygons.begin(); it != globalPolygons.end(); it++)
+		it->vdata->users++;
 
 	// The bitmap will be divided into strips, of height rowsPerStrip.
 	// Polygons are plotted for each strip consecutively in a loop, where the strip y coordinate equals ystart
@@ -580,18 +1039,21 @@ int main (int argc, char **argv)
 		{
 			while (polyIterator != globalPolygons.end() && y == (polyIterator->pixelMinY))
 			{
-				activePolys.push_back( PolygonReference() );
-				activePolys.back().polygon = &(*polyIterator);
-				activePolys.sort();
+				// the active polygons are kept in drawing order, a new polygon goes after those of the same number
+				PolygonReference reference;
+				reference.polygon = &(*polyIterator);
+				activePolys.insert(reference);
+				polyIterator->beginScanLines();
 //				printf("added poly %d (y=%d)\n", activePolys.back().polygon->number, y);
 				polyIterator++;
 			}
 
-			for (list<PolygonReference>::iterator it = activePolys.begin();  it != activePolys.end();)
+			for (multiset<PolygonReference>::iterator it = activePolys.begin();  it != activePolys.end();)
 			{
 				if (y > it->polygon->pixelMaxY)
 				{
 //					printf("erased poly %d (y=%d)\n", activePolys.back().polygon->number, y);
+					it->polygon->finishScanLines();
 					it = activePolys.erase(it);
 					continue;
 				}
@@ -0,0 +1,120 @@
+/*	Read only memory mapping of input files.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+#include "mappedfile.h"
+
+
+MappedFile::MappedFile()
+{
+	data = 0;
+	size = 0;
+#ifdef __linux__
+	fd = -1;
+#else
+	hFile = INVALID_HANDLE_VALUE;
+	hMapping = 0;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	unmap();
+}
+
+
+bool MappedFile::map(const char * filename)
+{
+	unmap();
+#ifdef __linux__
+	fd = open(filename, O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+	{
+		unmap();
+		return false;
+	}
+	size = st.st_size;
+	if (size == 0)
+		return true;
+	void * p = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (p == MAP_FAILED)
+	{
+		size = 0;
+		unmap();
+		return false;
+	}
+	madvise(p, size, MADV_SEQUENTIAL);		// the file is read once from start to end
+	data = (const char *)p;
+#else
+	hFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(hFile, &fileSize))
+	{
+		unmap();
+		return false;
+	}
+	size = (size_t)fileSize.QuadPart;
+	if (size == 0)
+		return true;
+	hMapping = CreateFileMappingA(hFile, 0, PAGE_READONLY, 0, 0, 0);
+	if (hMapping)
+		data = (const char *)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == 0)
+	{
+		size = 0;
+		unmap();
+		return false;
+	}
+#endif
+	return true;
+}
+
+
+void MappedFile::unmap()
+{
+#ifdef __linux__
+	if (data)
+		munmap((void *)data, size);
+	if (fd >= 0)
+		close(fd);
+	fd = -1;
+#else
+	if (data)
+		UnmapViewOfFile(data);
+	if (hMapping)
+		CloseHandle(hMapping);
+	if (hFile != INVALID_HANDLE_VALUE)
+		CloseHandle(hFile);
+	hMapping = 0;
+	hFile = INVALID_HANDLE_VALUE;
+#endif
+	data = 0;
+	size = 0;
+}
@@ -0,0 +1,49 @@
+/*	Read only memory mapping of input files.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <stddef.h>
+
+// Maps a whole file read only into memory.
+// data and size are valid after a successful map() until the object is destroyed.
+// An empty file maps successfully with data = 0 and size = 0.
+class MappedFile
+{
+	public:
+		const char * data;
+		size_t size;
+
+		MappedFile();
+		~MappedFile();
+		bool map(const char * filename);	// returns false if the file cannot be opened or mapped
+		void unmap();
+
+	private:
+		MappedFile(const MappedFile &);
+		MappedFile & operator=(const MappedFile &);
+#ifdef __linux__
+		int fd;
+#else
+		void * hFile;						// Windows HANDLE of the file and of the mapping object
+		void * hMapping;
+#endif
+};
+
+
+#endif  // MAPPEDFILE_H_
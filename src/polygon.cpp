@@ -6,16 +6,32 @@
 #include <list>
 #include <cctype>
 #include <math.h>
+#include <float.h>
 
 using namespace std;
 
 #include "polygon.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define STEP_EDGES_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define STEP_EDGES_SSE2
+#endif
 #ifndef __linux__
 #include "corecrt_math_defines.h"
 #endif
 //#define DEBUG
 
 
+// Intersections of a polygon up to which its scan line data is made by initialise(), about 1 MB
+size_t VertexData::maxTableIntersections = 1 << 18;
+
+// Edges of a polygon from which they are bucketed by scan line rather than sorted, see makeEdges()
+static const size_t minBucketedEdges = 1024;
+
+
 /*
  * High speed double to integer conversion replacement for int(floor(0.5 + x))
  * This function is used when converting real coordinates to pixel coordinates.
@@ -35,51 +51,6 @@ inline Point roundDot( Point &p)
 }
 
 
-/*
- * The Edge object for defining information for an edge of a polygon.
- * Edge class is used by polygon scan line filling algorithm as implimented in Polygon::initialise().
- */
-class Edge
-{
-public:
-	double delta_x;
-	double delta_y;
-	double C;
-	bool includeBottom;
-	double ymin;
-	double ymax;
-	int number; // used for debugging
-
-	// Define < to be used for sorting edges in a list of ascending ymin.
-	bool operator<( const Edge &rhs) const
-	{
-		return (ymin < rhs.ymin);
-	}
-
-	// Define a Edge line from point p1 to point p2.
-	Edge(const Point &p1, const Point &p2 )
-		 : includeBottom(false)
-	{
-
-		ymin = min(p1.y, p2.y);
-		ymax = max(p1.y, p2.y);
-
-	    delta_x = p2.x - p1.x;
-	    delta_y = p2.y - p1.y;
-
-    	C = p1.x*delta_y - p1.y*delta_x;
-	}
-
-	// Line equation to return x coordinate from y.
-	// Used by polygon fill algorithm to get the x coordinate of scan line intersect.
-	inline double x(double y)
-	{
-		return (y * delta_x + C) / delta_y;	// delta_y should never be zero, as such Edges are excluded from Edge table
-	}
-};
-
-
-
 /*
  *  Polygon initialisation.
  *   - Sets min and max variables from vertex data.
@@ -109,39 +80,282 @@ void Polygon::initialise()
  */
 void VertexData::initialise()
 {
+	initialiseExtents();
+	initialiseScanLines();
+}
+
+
+/*
+ *  Creates the scan line data, or keeps the edges of a large polygon. initialiseExtents() must have been called.
+ */
+void VertexData::initialiseScanLines()
+{
+	hasScanLines = true;
 	if (vertices.size() == 0)		// nothing to do with no vertices
 		return;
 
-	minx = miny = INT_MAX;
-	maxx = maxy = INT_MIN;
+	// Every row of a rectangle with sides parallel to the axes is the same span, made without the edge table:
+	// the x of its upright sides half way up, as the active edge table has them
+	double firstLine = roundDot(miny) + 0.5;
+	if (pixelHeigth > 0 && firstLine <= maxy && isRectangle())
+	{
+		double left = DBL_MAX, right = -DBL_MAX;
+		for (int i=0; i < 4; i++)
+		{
+			const Point &p1 = vertices[(i + 3) % 4], &p2 = vertices[i];
+			if (fabs(p2.x - p1.x) < fabs(p2.y - p1.y))
+			{
+				double x = Edge(p1, p2).x((miny + maxy) / 2);
+				left = min(left, x);
+				right = max(right, x);
+			}
+		}
+		chordRow[0] = roundDot(left);
+		chordRow[1] = roundDot(right);
+		rectangleRows = min(pixelHeigth, int(maxy - firstLine)) + 1;
+		return;
+	}
 
-	for (int i=0; i < vertices.size(); i++)
+	vector<Edge> edgeTable;
+	makeEdges(edgeTable);
+	if (edgeTable.size() == 0) // bug fixed by MinWang
+		return;
+
+	// Special case with  < 1 pixel high polygon that is assumed to be a single horizontal line.
+	// Action: A single x1 x2 pair for horizontal line from polygon's minx to maxx at where y coordinate is at miny = maxy
+	//С1صĶ Ϊֱ
+	if (pixelHeigth == 0)
 	{
-		Point p = vertices[i];
+		linesInCounts.push_back(2);
+		gxIntersects.push_back( roundDot( minx ) );
+		gxIntersects.push_back( roundDot( maxx ) );
+		return;
+	}
 
-		if (p.x < minx)		{ minx = p.x; }
-		if (p.y < miny) 	{ miny = p.y; }
-		if (p.x > maxx) 	{ maxx = p.x; }
-		if (p.y > maxy) 	{ maxy = p.y; }
+	// A circle or obround drawn once, e.g. a trace, keeps its edges only and is scanned from its chords while rendering
+	if (isChordScan(users))
+	{
+		edges.swap(edgeTable);
+		hasChords = true;
+		return;
 	}
 
-	pixelHeigth = roundDot(maxy - miny );
-	pixelWidth  = roundDot(maxx - minx );
+	// A large polygon keeps its edges only, the scan lines are made while rendering
+	size_t intersections = estimateIntersections();
+	if (isActiveEdgeScan(intersections))
+	{
+		edges.swap(edgeTable);
+		return;
+	}
+
+	// Allocate the scan line data once
+	gxIntersects.reserve( intersections );
+	linesInCounts.reserve( pixelHeigth + 1 );
+
+	// Run through the scan lines, of circles and obrounds from their chords
+	if (isObround())
+		scanObround(edgeTable);
+	else
+	{
+		ActiveEdgeTable scan(edgeTable, roundDot(miny) + 0.5);
+		for (int linedc = pixelHeigth; linedc >= 0 && scan.nextLine(); linedc--)
+		{
+			gxIntersects.insert(gxIntersects.end(), scan.x.begin(), scan.x.end());		// Store intersect X points as integer
+			linesInCounts.push_back(scan.x.size());
+		}
+	}
+
+	compactScanLines();
+}
+
+
+/*
+ *  True if the vertices are a circle or an obround as made by Aperture::render(), possibly rotated: two half circles
+ *  of the same radius joined by straight sides, or two arcs around the same centre.
+ */
+bool VertexData::isObround() const
+{
+	if (arcs.size() != 2 || arcs[0].vertex != 1 || arcs[0].isClockwise != arcs[1].isClockwise)
+		return false;
+	const double tolerance = 1e-6;
+	Point centre1 = arcs[0].centre, centre2 = arcs[1].centre;
+	if (fabs(arcs[1].radius - arcs[0].radius) > tolerance)
+		return false;
+	Point v0 = vertices[0], v1 = vertices[1], v2 = vertices[2];
+	if (vertices.size() == 3)		// circle, its last vertex closes it
+		return arcs[1].vertex == 2 && abs(centre2 - centre1) <= tolerance && abs(v2 - v0) <= tolerance;
+	if (vertices.size() != 4 || arcs[1].vertex != 3)
+		return false;
+
+	// each arc is a half circle, the sides are the same line moved from one centre to the other
+	Point v3 = vertices[3];
+	if (abs(v0 + v1 - centre1 * 2) > tolerance || abs(v2 + v3 - centre2 * 2) > tolerance
+			|| abs((v1 - centre1) - (v2 - centre2)) > tolerance)
+		return false;
+
+	// and bulges away from the other centre: its middle is a quarter turn from its start
+	Point middle = v0 - centre1;
+	middle.rotate(arcs[0].isClockwise ? -M_PI/2 : M_PI/2);
+	Point axis = centre2 - centre1;
+	return middle.x * axis.x + middle.y * axis.y <= 0;
+}
+
+
+/*
+ *  True if the vertices are a rectangle with sides parallel to the axes, e.g. of a rectangle aperture, a macro line
+ *  or a horizontal or vertical trace drawn with a rectangle aperture.
+ */
+bool VertexData::isRectangle() const
+{
+	if (vertices.size() != 4 || !arcs.empty())
+		return false;
+	const double tolerance = 1e-6;
+	bool isFirstVertical = fabs(vertices[1].x - vertices[0].x) <= tolerance;
+	for (int i=0; i < 4; i++)
+	{
+		const Point &p = vertices[i], &q = vertices[(i + 1) % 4];
+		bool isVertical = (i % 2 == 0) == isFirstVertical;
+		if (fabs(isVertical ? q.x - p.x : q.y - p.y) > tolerance)
+			return false;
+	}
+	return true;
+}
+
+
+/*
+ *  The chord of a circle or obround on scan line y, without the active edge table: the shape is convex, so the chord
+ *  runs from the leftmost to the rightmost edge crossing the line. The x of an edge is that of the active edge table,
+ *  for the arcs the chord of the circle computed by Edge::x(). Returns false below the shape.
+ */
+bool VertexData::chord(const vector<Edge> &edgeTable, double y, int row[2])
+{
+	double left = DBL_MAX, right = -DBL_MAX;
+	for (int i=0; i < edgeTable.size(); i++)
+	{
+		const Edge &edge = edgeTable[i];
+		if (y < edge.ymin)		// and all the edges after it
+			break;
+		if (y > edge.ymax)
+			continue;
+		double x = edge.x(y);
+		left = min(left, x);
+		right = max(right, x);
+	}
+	if (left > right)
+		return false;
+	row[0] = roundDot(left);
+	row[1] = roundDot(right);
+	return true;
+}
+
+
+/*
+ *  Makes the scan line data of a circle or obround shared by several polygons from its chords, see chord().
+ */
+void VertexData::scanObround(const vector<Edge> &edgeTable)
+{
+	double y = roundDot(miny) + 0.5;
+	int row[2];
+	for (int linedc = pixelHeigth; linedc >= 0 && chord(edgeTable, y, row); linedc--, y += 1.0)
+	{
+		gxIntersects.insert(gxIntersects.end(), row, row + 2);
+		linesInCounts.push_back(2);
+	}
+}
+
+
+/*
+ *  Replaces the scan line data with a compact copy. Runs of identical rows, e.g. of rectangles and the sides
+ *  of obrounds, are stored once in compact->runs: a word holding the count of intersections in its low byte and
+ *  the number of rows in its high byte, followed by the intersections as offsets from the left edge of the shape.
+ *  The data is left as it is for rows of more than 255 intersections or shapes wider than 65535 pixels.
+ */
+void VertexData::compactScanLines()
+{
+	if (gxIntersects.empty())
+		return;
+	int left = *min_element(gxIntersects.begin(), gxIntersects.end());
+	if (*max_element(gxIntersects.begin(), gxIntersects.end()) - left > 0xffff)
+		return;
+
+	vector<unsigned short> runs;
+	runs.reserve(linesInCounts.size() + gxIntersects.size());
+	size_t maxCount = 0;
+	size_t run = 0;					// header of the last run
+	const int * runRow = 0;			// and its first row
+	const int * row = &gxIntersects.front();
+	for (int i=0; i < linesInCounts.size(); i++)
+	{
+		int n = linesInCounts[i];
+		if (n > 0xff)
+			return;
+		if (runRow && n == (runs[run] & 0xff) && (runs[run] >> 8) < 0xff && equal(row, row + n, runRow))
+			runs[run] += 0x100;
+		else
+		{
+			run = runs.size();
+			runs.push_back(n | 0x100);
+			for (int k=0; k < n; k++)
+				runs.push_back(row[k] - left);
+			runRow = row;
+			maxCount = max(maxCount, size_t(n));
+		}
+		row += n;
+	}
+
+	compact = new CompactScanLines;
+	compact->runs.assign(runs.begin(), runs.end());
+	compact->row.resize(maxCount);
+	compact->left = left;
+	vector<int>().swap(gxIntersects);
+	vector<int>().swap(linesInCounts);
+}
+
+
+/*
+ *  Frees the scan line data once all the polygons using it have been rendered.
+ */
+void VertexData::releaseScanLines()
+{
+	vector<int>().swap(gxIntersects);
+	vector<int>().swap(linesInCounts);
+	vector<Edge>().swap(edges);
+	delete compact;
+	compact = 0;
+	hasChords = false;
+	rectangleRows = 0;
+	hasScanLines = false;
+}
 
-	list<Edge>  edges;
-	list< Edge * >  active;	// Active edge list. Points to the  edges that intersect the current scan line
 
+/*
+ *  Builds the global edge table: the edges of the polygon that are not horizontal, sorted by ascending ymin
+ *  or by the scan line they start on. Arcs are split where they turn up or down, into edges within the left
+ *  or right half of their circle. initialiseExtents() must have been called.
+ */
+void VertexData::makeEdges(vector<Edge> &edgeTable)
+{
+	edgeTable.reserve(vertices.size() + 2 * arcs.size());
 	Point p1 = vertices.back();
+	size_t arc = 0;
 
-	// Build Global Edges Table
-	// Edges are initially stored in list #edge in same order as polygon boundary path.
+	// Edges are initially stored in same order as polygon boundary path.
 	// All horizontal edges are excluded from table.
 	for (int i=0; i < vertices.size(); i++)
 	{
 		Point p2 = vertices[i];
-		if ( p1.y != p2.y )
+		if (arc < arcs.size() && arcs[arc].vertex == i)
+		{
+			Point points[6];
+			int n = arcPoints(arc, M_PI/2, M_PI, points);
+			for (int k=1; k < n; k++)
+				if ( points[k-1].y != points[k].y )
+					edgeTable.push_back( Edge(points[k-1], points[k], arcs[arc].centre, arcs[arc].radius, arcs[arc].isClockwise) );
+			arc++;
+		}
+		else if ( p1.y != p2.y )
 		{
-			edges.push_back( Edge(p1, p2) );
+			edgeTable.push_back( Edge(p1, p2) );
 		}
 		p1 = p2;
 	}
@@ -150,11 +364,10 @@ void VertexData::initialise()
 	// Determine edges that have a bottom vertex which has higher y value than either of it's neighbouring vertices.
 	// Such edges are flagged includeBottom, so in the scan line loop, the edge is not removed from the active list
 	// until the very bottom of the edge is scanned. This prevents vertices and bottom horizontal lines being missed in the plot.
-	if (edges.size() == 0) // bug fixed by MinWang
+	if (edgeTable.size() == 0)
 		return;
-	list<Edge>::iterator pit = edges.end();
-	pit--;
-	for ( list<Edge>::iterator it = edges.begin(); it != edges.end(); it++)
+	Edge * pit = &edgeTable.back();
+	for (vector<Edge>::iterator it = edgeTable.begin(); it != edgeTable.end(); it++)
 	{
 		// When this edge is pointing up (y1 > y2) and the previous edge pointing down (y2 > y1) then its a bottom
 		if ((it->delta_y < 0) && (pit->delta_y > 0))
@@ -162,73 +375,440 @@ void VertexData::initialise()
 			pit->includeBottom = true;
 			it->includeBottom = true;
 		}
-		pit = it;
+		pit = &*it;
 	}
 
-	// Special case with  < 1 pixel high polygon that is assumed to be a single horizontal line.
-	// Action: A single x1 x2 pair for horizontal line from polygon's minx to maxx at where y coordinate is at miny = maxy
-	//С1صĶ Ϊֱ
-	if (pixelHeigth == 0)
+	// All edges in table are to be sorted with ascending ymin points.
+	if (edgeTable.size() < minBucketedEdges)
 	{
-		linesInCounts.push_back(2);
-		gxIntersects.push_back( roundDot( minx ) );
-		gxIntersects.push_back( roundDot( maxx ) );
+		stable_sort(edgeTable.begin(), edgeTable.end());
 		return;
 	}
 
-	// All edges in table are to be sorted with ascending ymin points.
-	edges.sort();
-	list<Edge>::iterator currentEdge = edges.begin();
-	int count = 0;
+	// Large polygons, mostly regions, are bucketed by the scan line the edges start on instead, in linear time.
+	// ActiveEdgeTable adds all the edges of a scan line together, their order within it does not matter.
+	double firstLine = roundDot(miny) + 0.5;
+	int lines = pixelHeigth + 1;						// the last bucket holds the edges starting below the last line
+	vector<int> bucket(edgeTable.size());
+	vector<int> start(lines + 2, 0);
+	for (int i=0; i < edgeTable.size(); i++)
+	{
+		double ymin = edgeTable[i].ymin;
+		int line = int(max(0.0, min(double(lines), ceil(ymin - firstLine))));
+		while (line > 0 && firstLine + (line - 1) >= ymin)	// first scan line with y >= ymin
+			line--;
+		while (line < lines && firstLine + line < ymin)
+			line++;
+		bucket[i] = line;
+		start[line + 1]++;
+	}
+	for (int i=1; i < start.size(); i++)
+		start[i] += start[i - 1];
+	vector<Edge> sorted(edgeTable.size(), edgeTable.front());
+	for (int i=0; i < edgeTable.size(); i++)
+		sorted[start[bucket[i]]++] = edgeTable[i];
+	edgeTable.swap(sorted);
+}
 
-	// Run through the scan lines
-	double y = roundDot(miny) + 0.5;
-	for (int linedc = pixelHeigth; linedc >= 0; linedc--, y += 1.0)
+
+/*
+ *  Starts the scan at the line firstLine. Most polygons are small, their active edges fit the room reserved here.
+ */
+ActiveEdgeTable::ActiveEdgeTable(const vector<Edge> &edges, double firstLine)
+	: edges(edges), nextEdge(0), y(firstLine), line(0)
+{
+	size_t size = min(edges.size(), size_t(64));
+	fx.reserve(size);
+	dx.reserve(size);
+	offset.reserve(size);
+	window.reserve(size);
+	lastLine.reserve(size);
+	edge.reserve(size);
+	x.reserve(size);
+}
+
+
+/*
+ *  Advances to the next scan line and sets x to its intersections.
+ *  Returns false when no edge crosses the scan line, the polygon has then been scanned.
+ */
+bool ActiveEdgeTable::nextLine()
+{
+	//
+	// Add active edges to the list which have y1 located on current scan line.
+	//
+	while (nextEdge < edges.size() && y >= edges[nextEdge].ymin)
+		addEdge(nextEdge++);
+
+	stepEdges();
+	sortEdges();
+	y += 1.0;
+	line++;
+	if (x.size() == 0) // bug fixed by MinWang
+		return false;
+
+	if (x.size() & 1)
+		throw string("Execution error. (polygon scan line data not even)");
+	return true;
+}
+
+
+/*
+ *  Sets x of the active edges from their fixed point x and steps that to the next scan line, four edges
+ *  at a time with SSE2 or AVX2 when the compiler targets them. The edges that have crossed their last
+ *  scan line are removed on the way.
+ */
+void ActiveEdgeTable::stepEdges()
+{
+	size_t count = fx.size();
+	size_t i = 0, j = 0;				// edge read and written
+#if defined(STEP_EDGES_AVX2) || defined(STEP_EDGES_SSE2)
+	const __m128i sign = _mm_set1_epi32(0x80000000);
+	const __m128i thisLine = _mm_set1_epi32(line);
+#ifdef STEP_EDGES_AVX2
+	const __m256i half = _mm256_set1_epi64x(0x80000000LL);
+	const __m256i odd = _mm256_setr_epi32(1, 3, 5, 7, 0, 2, 4, 6);
+#else
+	const __m128i half = _mm_set_epi32(0, 0x80000000, 0, 0x80000000);
+#endif
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i o = _mm_loadu_si128((const __m128i *)&offset[i]);
+		__m128i w = _mm_loadu_si128((const __m128i *)&window[i]);
+		__m128i l = _mm_loadu_si128((const __m128i *)&lastLine[i]);
+#ifdef STEP_EDGES_AVX2
+		__m256i f = _mm256_loadu_si256((const __m256i *)&fx[i]);
+		__m256i d = _mm256_loadu_si256((const __m256i *)&dx[i]);
+		__m128i fraction = _mm256_extracti128_si256(_mm256_permutevar8x32_epi32(f, odd), 1);
+#else
+		__m128i f0 = _mm_loadu_si128((const __m128i *)&fx[i]);
+		__m128i f1 = _mm_loadu_si128((const __m128i *)&fx[i + 2]);
+		__m128i fraction = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(f0), _mm_castsi128_ps(f1), _MM_SHUFFLE(2, 0, 2, 0)));
+#endif
+		// unsigned fraction + offset > window, compared as signed with the sign bits flipped
+		__m128i rounded = _mm_cmpgt_epi32(_mm_xor_si128(_mm_add_epi32(fraction, o), sign), _mm_xor_si128(w, sign));
+		if (_mm_movemask_epi8(_mm_andnot_si128(_mm_cmplt_epi32(l, thisLine), rounded)) != 0xffff)
+		{
+			for (size_t k = i; k < i + 4; k++)
+				j = stepEdge(k, j);
+			continue;
+		}
+#ifdef STEP_EDGES_AVX2
+		_mm_storeu_si128((__m128i *)&x[j], _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_add_epi64(f, half), odd)));
+		_mm256_storeu_si256((__m256i *)&fx[j], _mm256_add_epi64(f, d));
+		if (j != i)
+			_mm256_storeu_si256((__m256i *)&dx[j], d);
+#else
+		__m128 r0 = _mm_castsi128_ps(_mm_add_epi64(f0, half));
+		__m128 r1 = _mm_castsi128_ps(_mm_add_epi64(f1, half));
+		_mm_storeu_si128((__m128i *)&x[j], _mm_castps_si128(_mm_shuffle_ps(r0, r1, _MM_SHUFFLE(3, 1, 3, 1))));
+		__m128i d0 = _mm_loadu_si128((const __m128i *)&dx[i]);
+		__m128i d1 = _mm_loadu_si128((const __m128i *)&dx[i + 2]);
+		_mm_storeu_si128((__m128i *)&fx[j], _mm_add_epi64(f0, d0));
+		_mm_storeu_si128((__m128i *)&fx[j + 2], _mm_add_epi64(f1, d1));
+		if (j != i)
+		{
+			_mm_storeu_si128((__m128i *)&dx[j], d0);
+			_mm_storeu_si128((__m128i *)&dx[j + 2], d1);
+		}
+#endif
+		if (j != i)
+		{
+			_mm_storeu_si128((__m128i *)&offset[j], o);
+			_mm_storeu_si128((__m128i *)&window[j], w);
+			_mm_storeu_si128((__m128i *)&lastLine[j], l);
+			_mm_storeu_si128((__m128i *)&edge[j], _mm_loadu_si128((const __m128i *)&edge[i]));
+		}
+		j += 4;
+	}
+#endif
+	for (; i < count; i++)
+		j = stepEdge(i, j);
+
+	if (j < count)
 	{
-		//
-		// Add active edges to the list which have y1 located on current scan line.
-		//
-		while (y >= (currentEdge->ymin) && currentEdge != edges.end() && count != edges.size())
+		fx.resize(j);
+		dx.resize(j);
+		offset.resize(j);
+		window.resize(j);
+		lastLine.resize(j);
+		edge.resize(j);
+		x.resize(j);
+	}
+}
+
+
+/*
+ *  Steps edge i for stepEdges() and moves it to j, unless it has crossed its last scan line.
+ *  Returns the next edge to write.
+ */
+size_t ActiveEdgeTable::stepEdge(size_t i, size_t j)
+{
+	if (lastLine[i] < line)
+		return j;
+	if (unsigned(fx[i]) + offset[i] > window[i])
+		x[j] = int((fx[i] + 0x80000000LL) >> 32);
+	else
+		x[j] = roundDot( edges[edge[i]].x( y ));
+	fx[j] = fx[i] + dx[i];
+	if (j != i)
+	{
+		dx[j] = dx[i];
+		offset[j] = offset[i];
+		window[j] = window[i];
+		lastLine[j] = lastLine[i];
+		edge[j] = edge[i];
+	}
+	return j + 1;
+}
+
+
+/*
+ *  Sorts the edges by insertion, as they are still sorted from the previous scan line unless they cross.
+ */
+void ActiveEdgeTable::sortEdges()
+{
+	for (size_t i=1; i < x.size(); i++)
+	{
+#ifdef DEBUG
+		if (x[i] != roundDot( edges[edge[i]].x( y )))
+			printf("edge stepped to %d instead of %d on line %f\n", x[i], roundDot( edges[edge[i]].x( y )), y);
+#endif
+		if (x[i - 1] <= x[i])
+			continue;
+		long long f = fx[i], d = dx[i];
+		unsigned o = offset[i], w = window[i];
+		int l = lastLine[i], e = edge[i], xi = x[i];
+		size_t k = i;
+		for (; k > 0 && x[k-1] > xi; k--)
 		{
-			active.push_back( &(*currentEdge)  );
-			count++;	
-			if (count == edges.size()) //bug fixed by MinWang
-				break;
-			currentEdge++;
+			fx[k] = fx[k-1];
+			dx[k] = dx[k-1];
+			offset[k] = offset[k-1];
+			window[k] = window[k-1];
+			lastLine[k] = lastLine[k-1];
+			edge[k] = edge[k-1];
+			x[k] = x[k-1];
 		}
+		fx[k] = f;
+		dx[k] = d;
+		offset[k] = o;
+		window[k] = w;
+		lastLine[k] = l;
+		edge[k] = e;
+		x[k] = xi;
+	}
+}
+
 
-		// Remove edges from active list
-		// When the scan line is equal to or greater than the bottom of the edge then it shall be removed.
-		// This avoids double counting due to a joining edge below this edge.
-		for (list<Edge *>::iterator it = active.begin(); it != active.end(); )
+/*
+ *  Adds an edge starting on the current scan line to the active edges. Its x is stepped from line to line in 32.32 fixed point
+ *  rather than divided on each line. The rounding of roundDot(edge->x(y)) is kept exactly: x is computed
+ *  from the edge instead when the stepped x is within the error of both methods from a half pixel,
+ *  for edges too steep or too far out for the fixed point, and on every line for arcs.
+ */
+void ActiveEdgeTable::addEdge(int index)
+{
+	const Edge * e = &edges[index];
+
+	// When the scan line is equal to or greater than the bottom of the edge then it shall be removed.
+	// This avoids double counting due to a joining edge below this edge.
+	int lines = max(0, int(e->ymax - y));
+	while (lines > 0 && !e->crosses(y + lines - 1))
+		lines--;
+	while (e->crosses(y + lines))
+		lines++;
+
+	long long f = 0, d = 0;
+	unsigned o = 0, w = 0xffffffff;			// never rounded
+	double x0 = e->x(y);
+	double slope = e->delta_x / e->delta_y;
+	if (e->radius == 0 && fabs(x0) < 0x40000000 && fabs(slope) < 0x100000 && lines * (fabs(slope) + 1) < 0x40000000)
+	{
+		const double one = 4294967296.0;		// 1 in 32.32 fixed point
+		// error of edge->x() as computed in double, a few units in the last place of its terms
+		double xError = ((max(fabs(e->ymin), fabs(e->ymax)) * fabs(e->delta_x) + fabs(e->C)) / fabs(e->delta_y)
+				+ fabs(x0) + lines * fabs(slope) + 1) * ldexp(1.0, -49);
+		f = (long long)(x0 * one);
+		d = (long long)(slope * one);
+		// the fraction is further than margin from a half when (fraction + margin - half) mod 2^32 > 2 * margin
+		double margin = 2 * xError * one + lines * (2 + fabs(slope) * ldexp(1.0, -20)) + 2;
+		if (margin < 0x40000000)
 		{
-			if ( y > ((*it)->ymax) || (y == ((*it)->ymax) && !(*it)->includeBottom))
-			{
-				it = active.erase(it);
-				continue;
-			}
-			it++;
+			o = unsigned(margin) - 0x80000000u;
+			w = 2 * unsigned(margin);
 		}
-		if (active.size() == 0) // bug fixed by MinWang
+	}
+
+	// inserted in x order of the previous line, the edges are then rarely moved by sortEdges()
+	size_t i = upper_bound(x.begin(), x.end(), roundDot(x0)) - x.begin();
+	fx.insert(fx.begin() + i, f);
+	dx.insert(dx.begin() + i, d);
+	offset.insert(offset.begin() + i, o);
+	window.insert(window.begin() + i, w);
+	lastLine.insert(lastLine.begin() + i, line + lines - 1);
+	edge.insert(edge.begin() + i, index);
+	x.insert(x.begin() + i, roundDot(x0));
+}
+
+
+/*
+ *  Scan line data of a polygon that keeps only its edges, made one scan line at a time as it is rendered.
+ *  The chord of a circle or obround is held by the vertex data, it has no other users.
+ */
+void Polygon::getNextActiveEdgeLine(int * &sliTable, int &sliCount)
+{
+	sliCount = 0;
+	if (count > vdata->pixelHeigth)
+		return;
+	if (vdata->hasChords)
+	{
+		if (!VertexData::chord(vdata->edges, roundDot(vdata->miny) + 0.5 + count, vdata->chordRow))
+		{
+			count = vdata->pixelHeigth + 1;		// no more scan lines
 			return;
-		//printf(" y(%3f)  ", y);
-		for (list<Edge *>::iterator it = active.begin(); it != active.end(); it++)
+		}
+		count++;
+		sliCount = 2;
+		sliTable = vdata->chordRow;
+		return;
+	}
+	if (activeEdges == 0)
+		activeEdges = new ActiveEdgeTable(vdata->edges, roundDot(vdata->miny) + 0.5);
+	count++;
+	if (!activeEdges->nextLine())
+	{
+		count = vdata->pixelHeigth + 1;		// no more scan lines
+		return;
+	}
+	sliCount = activeEdges->x.size();
+	sliTable = &activeEdges->x.front();
+}
+
+/*
+ *  Scan line data of a polygon with compact vertex data, decoded one scan line at a time as it is rendered.
+ *  The row is held by the vertex data and is therefore only valid until the next call for a polygon using it.
+ */
+void Polygon::getNextCompactLine(int * &sliTable, int &sliCount)
+{
+	const vector<unsigned short> &runs = vdata->compact->runs;
+	if (nextInRuns == 0)
+		nextInRuns = &runs.front();
+	if (nextInRuns == &runs.front() + runs.size())
+	{
+		sliCount = 0;
+		return;
+	}
+	sliCount = *nextInRuns & 0xff;
+	const unsigned short * x = nextInRuns + 1;
+	int * row = &vdata->compact->row.front();
+	int left = vdata->compact->left;
+	for (int i=0; i < sliCount; i++)
+		row[i] = left + x[i];
+	sliTable = row;
+	if (++count == (*nextInRuns >> 8))		// last row of the run
+	{
+		count = 0;
+		nextInRuns = x + sliCount;
+	}
+}
+
+/*
+ *  Makes the scan line data of the vertices when the first polygon using them is about to be rendered.
+ */
+void Polygon::beginScanLines()
+{
+	if (!vdata->hasScanLines)
+		vdata->initialiseScanLines();
+}
+
+/*
+ *  Frees the scan state of a polygon once it has been rendered, and the scan line data
+ *  of its vertices once the last polygon using them has been rendered.
+ */
+void Polygon::finishScanLines()
+{
+	delete activeEdges;
+	activeEdges = 0;
+	if (--vdata->users == 0)
+		vdata->releaseScanLines();
+}
+
+
+/*
+ *  Sets the min and max variables and the pixel size from the vertex data, without the scan line data.
+ */
+void VertexData::initialiseExtents()
+{
+	minx = miny = INT_MAX;
+	maxx = maxy = INT_MIN;
+
+	for (int i=0; i < vertices.size(); i++)
+	{
+		Point p = vertices[i];
+
+		if (p.x < minx)		{ minx = p.x; }
+		if (p.y < miny) 	{ miny = p.y; }
+		if (p.x > maxx) 	{ maxx = p.x; }
+		if (p.y > maxy) 	{ maxy = p.y; }
+	}
+
+	// arcs bulge out to where they cross the axes through their centre
+	for (int i=0; i < arcs.size(); i++)
+	{
+		Point points[6];
+		int n = arcPoints(i, 0, M_PI/2, points);
+		for (int k=1; k < n - 1; k++)
 		{
-			int x = roundDot( (*it)->x( y ));
-			gxIntersects.push_back( x );		// Store intersect X point as integer
-//			printf("%4d ", x );
+			minx = min(minx, points[k].x);
+			miny = min(miny, points[k].y);
+			maxx = max(maxx, points[k].x);
+			maxy = max(maxy, points[k].y);
 		}
-//		printf("\n");
+	}
 
-		int sliCount = active.size();
-		linesInCounts.push_back(sliCount);
+	pixelHeigth = roundDot(maxy - miny );
+	pixelWidth  = roundDot(maxx - minx );
+}
 
-		if (sliCount & 1)
-	    	throw string("Execution error. (polygon scan line data not even)");
 
-		// Sort all x intersections for this scan line
-		sort( gxIntersects.end() - sliCount, gxIntersects.end());
+/*
+ *  Predicts the number of scan line intersections initialise() stores, from the vertices alone:
+ *  every edge that is not horizontal crosses the scan lines between its end points, an arc those
+ *  between the points where it turns up or down. initialiseExtents() must have been called.
+ */
+size_t VertexData::estimateIntersections()
+{
+	if (vertices.size() == 0)
+		return 0;
+
+	double y0 = roundDot(miny) + 0.5;		// first scan line
+	double lines = pixelHeigth + 1;
+	size_t count = 0;
+	bool hasEdges = false;
+	size_t arc = 0;
+	Point p = vertices.back();
+	for (int i=0; i < vertices.size(); i++)
+	{
+		Point points[6] = { p, vertices[i] };
+		int n = (arc < arcs.size() && arcs[arc].vertex == i) ? arcPoints(arc++, M_PI/2, M_PI, points) : 2;
+		for (int k=1; k < n; k++)
+		{
+			const Point &p1 = points[k-1], &p2 = points[k];
+			if ( p1.y != p2.y )
+			{
+				hasEdges = true;
+				double first = max(0.0, ceil(min(p1.y, p2.y) - y0));
+				double last = min(lines, ceil(max(p1.y, p2.y) - y0));
+				if (last > first)
+					count += size_t(last - first);
+			}
+		}
+		p = vertices[i];
 	}
+	if (pixelHeigth == 0)					// a single horizontal line
+		return hasEdges ? 2 : 0;
+	return count;
 }
 
 
@@ -278,17 +858,26 @@ void VertexData::add( double x, double y)
 
 
 
+/*
+ *  Angle between the vertices of an arc approximation of radius >= 0.5
+ */
+static double arcStep(double radius)
+{
+	double deviaion = 0.01;
+	if (radius < 150)		deviaion *= (radius/150);
+	if (deviaion < 0.01)	deviaion = 0.01;
+	return 2*acos(1 - deviaion / radius);				// calculate minimum step magnitude to satisfy maximum deviation
+}
+
+
 /*
  *  Add vertices that follow an arc approximation
  */
 void VertexData::addArc(double start_angle, double end_angle, double radius, double x0, double y0, bool clockwise)
 {
 
-	double deviaion = 0.01;
 	if (radius < 0.5)		radius = 0.5;
-	if (radius < 150)		deviaion *= (radius/150);
-	if (deviaion < 0.01)	deviaion = 0.01;
-	double step = 2*acos(1 - deviaion / radius);				// calculate minimum step magnitude to satisfy maximum deviation
+	double step = arcStep(radius);
 
 	if (start_angle < 0)  start_angle += 2*M_PI;
 	if (end_angle < 0) 	  end_angle += 2*M_PI;
@@ -313,6 +902,93 @@ void VertexData::addArc(double start_angle, double end_angle, double radius, dou
 }
 
 
+/*
+ *  Add an arc kept as a curve: only its end points are added as vertices, the scan lines are intersected
+ *  with its circle. Arcs over half a circle are split in two.
+ */
+void VertexData::addArcEdge(double start_angle, double end_angle, double radius, double x0, double y0, bool clockwise)
+{
+	if (radius < 0.5)		radius = 0.5;
+	if (start_angle < 0)  start_angle += 2*M_PI;
+	if (end_angle < 0) 	  end_angle += 2*M_PI;
+
+	double arc = end_angle - start_angle;
+	if (arc < 0) arc +=  2*M_PI;
+	if (clockwise) 	arc = 2*M_PI - arc;
+	if (arc <= arcStep(radius))		// too short for two vertices of addArc()
+		return;
+
+	int N = (arc > M_PI) ? 2 : 1;
+	double step = arc / N;
+	if (clockwise) 	step *= -1;
+
+	add(radius * cos(start_angle) + x0, radius * sin(start_angle) + y0);
+	for (int i=1; i <= N; i++)
+	{
+		double const theta = start_angle + i * step;
+		size_t vertex = vertices.size();
+		add(radius * cos(theta) + x0, radius * sin(theta) + y0);
+		if (vertices.size() > vertex)		// else too short, left as a line
+		{
+			ArcSegment segment = { vertex, Point(x0, y0), radius, clockwise };
+			arcs.push_back(segment);
+		}
+	}
+}
+
+
+/*
+ *  Replaces the arcs by vertices that follow them as added by addArc(), e.g. before they are scaled unevenly.
+ */
+void VertexData::flattenArcs()
+{
+	vector<Point> curved;
+	vector<ArcSegment> segments;
+	curved.swap(vertices);
+	segments.swap(arcs);
+	size_t arc = 0;
+	for (size_t i=0; i < curved.size(); i++)
+	{
+		if (arc < segments.size() && segments[arc].vertex == i)
+		{
+			const ArcSegment &s = segments[arc++];
+			double start = atan2(curved[i-1].y - s.centre.y, curved[i-1].x - s.centre.x);
+			double end = atan2(curved[i].y - s.centre.y, curved[i].x - s.centre.x);
+			addArc(start, end, s.radius, s.centre.x, s.centre.y, s.isClockwise);
+		}
+		add(curved[i]);
+	}
+}
+
+
+/*
+ *  Points of arc from its start to its end vertex, with the points between where it crosses the axes through
+ *  its centre at firstAxis and every period from it. Returns the number of points, at most 6.
+ */
+int VertexData::arcPoints(size_t arc, double firstAxis, double period, Point points[6]) const
+{
+	const ArcSegment &s = arcs[arc];
+	const Point &start = vertices[s.vertex - 1];
+	const Point &end = vertices[s.vertex];
+	double direction = s.isClockwise ? -1 : 1;
+	double startAngle = atan2(start.y - s.centre.y, start.x - s.centre.x);
+	double sweep = direction * (atan2(end.y - s.centre.y, end.x - s.centre.x) - startAngle);
+	if (sweep < 0)	sweep += 2*M_PI;
+
+	int n = 0;
+	points[n++] = start;
+	double axis = fmod(direction * (firstAxis - startAngle), period);		// the first axis crossed
+	if (axis <= 0)	axis += period;
+	for (; axis < sweep && n < 5; axis += period)
+	{
+		double const theta = startAngle + direction * axis;
+		points[n++] = Point(s.radius * cos(theta) + s.centre.x, s.radius * sin(theta) + s.centre.y);
+	}
+	points[n++] = end;
+	return n;
+}
+
+
 /*
  * Add vertices for a regular N sided polygon
  */
@@ -359,13 +1035,20 @@ void VertexData::rotate(double theta)
 	{
 		vertices[i].rotate(theta);
 	}
+	for (int i=0; i < arcs.size(); i++)
+	{
+		arcs[i].centre.rotate(theta);
+	}
 }
 
 /*
  * Scale vertices of the polygon by multiplying all x coordinates by scaleX, and all y coordinates by scaleY
+ * Arcs are replaced by vertices when scaled unevenly, as they are no longer circular.
  */
 void VertexData::scale(double scaleX,  double scaleY )
 {
+	if (!arcs.empty() && fabs(scaleX) != fabs(scaleY))
+		flattenArcs();
 	int N = vertices.size();
 	if (N == 0)
 		return;
@@ -374,6 +1057,14 @@ void VertexData::scale(double scaleX,  double scaleY )
 		vertices[i].x *= scaleX;
 		vertices[i].y *= scaleY;
 	}
+	for (int i=0; i < arcs.size(); i++ )
+	{
+		arcs[i].centre.x *= scaleX;
+		arcs[i].centre.y *= scaleY;
+		arcs[i].radius *= fabs(scaleX);
+		if (scaleX * scaleY < 0)		// mirrored
+			arcs[i].isClockwise = !arcs[i].isClockwise;
+	}
 }
 
 
@@ -388,6 +1079,11 @@ void VertexData::shift(double x_shift, double y_shift)
 		it->x += x_shift;
 		it->y += y_shift;
 	}
+	for ( vector<ArcSegment>::iterator it = arcs.begin(); it != arcs.end(); it++ )
+	{
+		it->centre.x += x_shift;
+		it->centre.y += y_shift;
+	}
 }
 
 /*
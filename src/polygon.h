@@ -32,6 +32,31 @@ inline double abs_sq(const Point &P) { return (P.x*P.x + P.y*P.y); }
 inline double arg(const Point &P) { return atan2(P.y, P.x); }
 inline Point polar(const double &rho, const double &theta) { return Point( rho*cos(theta), rho*sin(theta)); }
 
+//
+// Axis aligned bounding box of points, empty until the first point is added.
+//
+class Extents
+{
+public:
+	double minx, miny, maxx, maxy;
+	Extents() : minx(1E100), miny(1E100), maxx(-1E100), maxy(-1E100) { }
+	bool empty() const	{ return minx > maxx; }
+	Point corner(int i) const	{ return Point((i & 1) ? maxx : minx, (i & 2) ? maxy : miny); }		// i = 0..3
+	void add(const Point &P)
+	{
+		minx = std::min(minx, P.x);
+		miny = std::min(miny, P.y);
+		maxx = std::max(maxx, P.x);
+		maxy = std::max(maxy, P.y);
+	}
+	void add(const Extents &E)
+	{
+		if (E.empty())	return;
+		add(Point(E.minx, E.miny));
+		add(Point(E.maxx, E.maxy));
+	}
+};
+
 //
 // A general line equation object
 //
@@ -101,6 +126,135 @@ public:
 };
 
 
+/*
+ * A circular arc from the vertex before vertex to vertex of a VertexData, kept as a curve rather than
+ * tessellated, see VertexData::addArcEdge(). It sweeps at most half a circle.
+ */
+struct ArcSegment
+{
+	size_t vertex;					// index of the vertex the arc ends on
+	Point centre;
+	double radius;
+	bool isClockwise;
+};
+
+
+/*
+ * The Edge object for defining information for an edge of a polygon.
+ * Edge class is used by polygon scan line filling algorithm as implimented in VertexData::initialise().
+ */
+class Edge
+{
+public:
+	double delta_x;
+	double delta_y;
+	double C;
+	bool includeBottom;
+	double ymin;
+	double ymax;
+	double radius;		// of an arc edge, negative on the left of its centre, 0 for a line
+	Point centre;
+	int number; // used for debugging
+
+	// Define < to be used for sorting edges in a list of ascending ymin.
+	bool operator<( const Edge &rhs) const
+	{
+		return (ymin < rhs.ymin);
+	}
+
+	// Define a Edge line from point p1 to point p2.
+	Edge(const Point &p1, const Point &p2 )
+		 : includeBottom(false), radius(0)
+	{
+
+		ymin = std::min(p1.y, p2.y);
+		ymax = std::max(p1.y, p2.y);
+
+	    delta_x = p2.x - p1.x;
+	    delta_y = p2.y - p1.y;
+
+    	C = p1.x*delta_y - p1.y*delta_x;
+	}
+
+	// Define a Edge arc from point p1 to point p2 of the circle at centre, within its left or right half.
+	Edge(const Point &p1, const Point &p2, const Point &centre, double radius, bool isClockwise)
+		 : includeBottom(false), centre(centre)
+	{
+		ymin = std::min(p1.y, p2.y);
+		ymax = std::max(p1.y, p2.y);
+
+	    delta_x = p2.x - p1.x;
+	    delta_y = p2.y - p1.y;
+    	C = p1.x*delta_y - p1.y*delta_x;
+
+		// going anticlockwise, y increases on the right half of the circle
+		this->radius = ((delta_y > 0) != isClockwise) ? radius : -radius;
+	}
+
+	// Line or circle equation to return x coordinate from y.
+	// Used by polygon fill algorithm to get the x coordinate of scan line intersect.
+	inline double x(double y) const
+	{
+		if (radius != 0)
+		{
+			double dy = y - centre.y;
+			double dx = sqrt(std::max(0.0, radius * radius - dy * dy));
+			return (radius > 0) ? centre.x + dx : centre.x - dx;
+		}
+		return (y * delta_x + C) / delta_y;	// delta_y should never be zero, as such Edges are excluded from Edge table
+	}
+
+	// True if the edge is still active on the scan line at y, its bottom only at the bottom of the polygon
+	inline bool crosses(double y) const
+	{
+		return y < ymax || (y == ymax && includeBottom);
+	}
+};
+
+
+/*
+ * Active edge table. Steps through the scan lines of a polygon from its edges sorted by ascending ymin,
+ * keeping only the edges that cross the current scan line. Its memory depends on the number of edges only.
+ * Used to make the scan line data of VertexData, or directly while rendering polygons too large for it.
+ */
+class ActiveEdgeTable
+{
+	const std::vector<Edge> &edges;
+	size_t nextEdge;				// first edge not yet added to the active edges
+	double y;						// next scan line
+	int line;						// and its number, from 0
+
+	// The active edges, in ascending x order of the previous line, one array per field so that they are stepped
+	// together by stepEdges(). x holds their intersections with the current line.
+	std::vector<long long> fx;		// x on the scan line in 32.32 fixed point, stepped by dx on each line
+	std::vector<long long> dx;
+	std::vector<unsigned> offset;	// fx is rounded when the fraction + offset > window, else x is computed, see addEdge()
+	std::vector<unsigned> window;
+	std::vector<int> lastLine;		// last scan line the edge crosses
+	std::vector<int> edge;			// index in edges
+	void addEdge(int index);
+	void stepEdges();
+	size_t stepEdge(size_t i, size_t j);
+	void sortEdges();
+public:
+	std::vector<int> x;				// sorted x intersections of the current scan line
+
+	ActiveEdgeTable(const std::vector<Edge> &edges, double firstLine);
+	bool nextLine();
+};
+
+
+/*
+ * Scan line data of a shape in compact form, see VertexData::compactScanLines()
+ */
+struct CompactScanLines
+{
+	std::vector<unsigned short> runs;	// runs of identical scan lines
+	std::vector<int> row;				// the scan line decoded last
+	int left;							// x the offsets in runs are from
+};
+
+
 /*
  * VertexData set of vertices and handles scan line filling.
  *
@@ -112,14 +266,32 @@ class VertexData
 private:
 	std::vector<int> gxIntersects;	// Vector of x coordinates that intersect each edge of polygon on consecutive scan lines
     std::vector<int> linesInCounts;	// For each scan line, linesInCounts holds number of x intersections.
+	std::vector<Edge> edges;		// Edges sorted by ascending ymin, kept instead of the scan line data when that is too large
+									// or the shape is scanned from its chords
+	CompactScanLines * compact;		// Scan line data in compact form, kept instead of the above when it fits
 	Point lastVertex;
 	friend class Polygon;
 	int pixelHeigth;
 	int pixelWidth;
+	void makeEdges(std::vector<Edge> &edgeTable);
+	void compactScanLines();
+	bool hasChords;					// circle or obround drawn once, scanned from the chords of its edges while rendering
+	int chordRow[2];				// the chord returned last, or the span of every row of a rectangle
+	int rectangleRows;				// scan lines of a rectangle with sides parallel to the axes, scanned without any data
+	bool isObround() const;
+	static bool chord(const std::vector<Edge> &edgeTable, double y, int row[2]);
+	void scanObround(const std::vector<Edge> &edgeTable);
 
 public:
 	std::vector<Point> vertices;	// All vertices in polygon
+	std::vector<ArcSegment> arcs;	// Edges between vertices that are arcs, in ascending vertex order
 	double minx, miny, maxx, maxy;
+	bool isShared;					// owned by the ApertureCache, its vertices are never changed
+	bool hasScanLines;				// the scan line data or the edges have been made
+	int users;						// polygons using this data still to be rendered, counted by the renderer
+
+	VertexData() : compact(0), hasChords(false), rectangleRows(0), isShared(false), hasScanLines(false), users(0) { }
+	~VertexData()	{ delete compact; }
 
 	bool empty()   	{ return (vertices.size()==0); }
 	void scale(double scaleX,  double scaleY );
@@ -128,9 +300,25 @@ public:
 	void add( double  x, double y );
 	void add( const Point &P );
 	void addArc( double start_angle, double end_angle, double radius, double x0=0, double y0=0, bool clockwise=false);
+	void addArcEdge( double start_angle, double end_angle, double radius, double x0=0, double y0=0, bool clockwise=false);
+	void flattenArcs();
+	int arcPoints(size_t arc, double firstAxis, double period, Point points[6]) const;
 	void addRegularPolygon( double face_radius, double start_angle, int num_sides, double x0=0, double y0=0);
 	void addRectangle( double x_size, double y_size, double x0=0, double y0=0);
 	void initialise();
+	void initialiseExtents();
+	void initialiseScanLines();
+	void releaseScanLines();
+	size_t estimateIntersections();				// of the scan line data, before initialise()
+	int height()	{ return pixelHeigth; }
+
+	// Polygons with more scan line intersections are scanned from their edges while rendering
+	static size_t maxTableIntersections;
+	static bool isActiveEdgeScan(size_t intersections)	{ return intersections > maxTableIntersections; }
+
+	// A circle or obround drawn by a single polygon, e.g. a trace, is scanned from its chords while rendering
+	bool isChordScan(int polygons) const	{ return polygons <= 1 && isObround(); }
+	bool isRectangle() const;
 };
 
 
@@ -142,9 +330,15 @@ public:
 class Polygon
 {
 private:
-	int * nextInTable;
+	union {
+		int * nextInTable;
+		const unsigned short * nextInRuns;			// run of the compact scan line data, count is then the rows of it done
+	};
 	int * nextInCount;
 	int count;
+	ActiveEdgeTable * activeEdges;					// scan state while rendering from the edges, see VertexData::edges
+	void getNextActiveEdgeLine(int * &sliTable, int &sliCount);
+	void getNextCompactLine(int * &sliTable, int &sliCount);
 
 public:
 	VertexData * vdata;
@@ -156,6 +350,8 @@ public:
 	Polarity_t polarity;							// The plotting polarity
 
 	void initialise();
+	void beginScanLines();
+	void finishScanLines();
 	std::vector<int> const & getNextLineX1X2Pairs();
 	bool empty()   	{ return vdata->empty(); }
 	bool operator<(const Polygon &rhs) const
@@ -167,6 +363,7 @@ public:
 				,nextInCount(0)
 				,nextInTable(0)
 				,count(0)
+				,activeEdges(0)
 				,vdata(new VertexData)
 	{ }
 
@@ -177,6 +374,20 @@ public:
 	 */
 	void getNextLineX1X2Pairs(int * &sliTable, int &sliCount )
 	{
+		if (vdata->rectangleRows) {
+			sliCount = (count < vdata->rectangleRows) ? 2 : 0;
+			sliTable = vdata->chordRow;
+			count++;
+			return;
+		}
+		if (!vdata->edges.empty()) {
+			getNextActiveEdgeLine(sliTable, sliCount);
+			return;
+		}
+		if (vdata->compact) {
+			getNextCompactLine(sliTable, sliCount);
+			return;
+		}
 		// bug fixed by MinWang
 		if (vdata->linesInCounts.size() == 0) {
 			sliCount = 0;